@@ -44,8 +44,18 @@ Usage:
 */
 
 										
+#ifndef MAX31856_HOST
 static SPISettings MAX31856_SPISettings = SPISettings(5000000, MSBFIRST, SPI_MODE1); //CPOL = 0, CHPA = 1
+#endif
 #define TABLENGTH 8
+#if defined(IRAM_ATTR)
+#define MAX31856_ISR_ATTR IRAM_ATTR	//Functions that may be called from a DRDY ISR have to live in RAM on the ESP parts
+#elif defined(ICACHE_RAM_ATTR)
+#define MAX31856_ISR_ATTR ICACHE_RAM_ATTR
+#else
+#define MAX31856_ISR_ATTR
+#endif
+#define MAX31856_NO_PIN 0xFF	//Use for CSPin/DRDYPin when the pin is not wired or is handled outside of this file
 struct MAX31856_REG_MAP_Struct {
 
 	union {
@@ -192,11 +202,110 @@ String ByteToBinaryAndHex(uint8_t b) {
 	return s;
 } //===============================================================================================
 
+/*
+Integer decode of the Linearized TC Temperature: the 19 bit signed code held in LTCBH/LTCBM/LTCBL, 1 LSB = 1/128C (0.0078125C)
+extras/host/MAX31856DecodeCheck.cpp checks it bit for bit against the original double arithmetic, MAX31856DecodeBench.cpp times it
+*/
+int32_t MAX31856DecodeLTC(struct MAX31856_REG_MAP_Struct * R) {
+	uint32_t Raw = (uint32_t(R->LTC.H) << 24) | (uint32_t(R->LTC.M) << 16) | (uint32_t(R->LTC.L) << 8);
+	return int32_t(Raw) >> 13; //Sign comes along with the shift, bottom 5 bits are unused
+} //===============================================================================================
+
+/*
+Compact integer form of the values that change every conversion.  8 bytes per device against the 56 bytes of doubles in
+MAX31856_REG_Struct, and no floating point needed to fill it in.  Convert to C only where it is actually displayed.
+Typical use:
+	MAX31856_Fixed_Struct T;
+	MAX31856ReadTemperature();
+	MAX31856CalculateFixed(&T);
+	if (T.LTC > 200 * 128) ... //Compare directly in 1/128C
+	Serial.println(MAX31856LTCToDouble(T.LTC), 4);
+*/
+struct MAX31856_Fixed_Struct {
+	int32_t LTC;	//Linearized TC Temperature in 1/128C
+	int16_t CJT;	//Cold Junction Temperature in 1/256C
+	uint8_t SR;		//Fault Status Register
+};
+void MAX31856CalculateFixed(struct MAX31856_Fixed_Struct * F, struct MAX31856_REG_Struct * M = &MAX31856) {
+	F->LTC = MAX31856DecodeLTC(&M->REG);
+	F->CJT = M->REG.CJT.CJT;
+	F->SR = M->REG.SR.WORD;
+} //===============================================================================================
+double MAX31856LTCToDouble(int32_t LTC) {
+	return double(LTC) * 0.0078125;
+} //===============================================================================================
+double MAX31856CJTToDouble(int16_t CJT) {
+	return double(CJT) * 0.00390625;
+} //===============================================================================================
+
+/*
+TCTYPE 8-11 and 12-15 put the MAX31856 in voltage mode at a gain of 8 or 32.  LTC then holds the thermocouple input voltage,
+Code = Gain * 1.6 * 2^17 * Vin, rather than a temperature.
+MAX31856VoltageGain() returns 8 or 32 in the voltage modes and 0 when the chip is linearizing a thermocouple itself
+*/
+uint8_t MAX31856VoltageGain(struct MAX31856_REG_Struct * M = &MAX31856) {
+	if (M->REG.CR1.TCTYPE >= 12) return 32;
+	if (M->REG.CR1.TCTYPE >= 8) return 8;
+	return 0;
+} //===============================================================================================
+double MAX31856LTCToVolts(int32_t LTC, uint8_t Gain) {
+	return double(LTC) / (double(Gain) * 209715.2);
+} //===============================================================================================
+
+/*
+Thermocouple input voltage in V from the LTC registers, NAN unless the MAX31856 is in a voltage mode
+*/
+double MAX31856LTCVolts(struct MAX31856_REG_Struct * M = &MAX31856) {
+	uint8_t Gain = MAX31856VoltageGain(M);
+	if (!Gain) return NAN;
+	return MAX31856LTCToVolts(MAX31856DecodeLTC(&M->REG), Gain);
+} //===============================================================================================
+
+/*
+Number of samples the MAX31856 averages per conversion, from CR1.AVGSEL
+*/
+uint8_t MAX31856AveragedSamples(struct MAX31856_REG_Struct * M = &MAX31856) {
+	if (M->REG.CR1.AVGSEL >= 4) return 16;
+	return 1 << M->REG.CR1.AVGSEL;
+} //===============================================================================================
+
+/*
+Estimated conversion time in ms, typical and maximum, for the conversion mode, notch filter and averaging in M.
+From the MAX31856 datasheet: the first conversion of a one shot takes longer, then each extra averaged sample adds a notch period.
+Typical Use:
+	float Tconv, TconvMax;
+	MAX31856ConversionTime(&Tconv, &TconvMax);
+*/
+void MAX31856ConversionTime(float * Tconv, float * TconvMax, struct MAX31856_REG_Struct * M = &MAX31856) {
+	uint8_t AveragedSamples = MAX31856AveragedSamples(M);
+	if (M->REG.CR0.CMODE) { //automatic conversion
+		if (M->REG.CR0.Hz50_60) { //50hz
+			*Tconv = 98.0		+ float(AveragedSamples - 1) * 20.0;
+			*TconvMax = 110.0	+ float(AveragedSamples - 1) * 20.0;
+		}
+		else {//60hz
+			*Tconv = 82.0		+ float(AveragedSamples - 1) * 16.67;
+			*TconvMax = 90.0	+ float(AveragedSamples - 1) * 16.67;
+		}
+	}
+	else {//one shot conversion
+		if (M->REG.CR0.Hz50_60) { //50hz
+			*Tconv = 169.0		+ float(AveragedSamples - 1) * 40.0;
+			*TconvMax = 185.0	+ float(AveragedSamples - 1) * 40.0;
+		}
+		else {//60hz
+			*Tconv = 143.0		+ float(AveragedSamples - 1) * 33.3;
+			*TconvMax = 155.0	+ float(AveragedSamples - 1) * 33.3;
+		}
+	}
+} //===============================================================================================
+
 /*
 Pass in a MAX31856_REG_Struct and this routine will calculate all of the doubles in the root of MAX31856 from the REG values
 Typical use: 
 	MAX31856ReadRegisters(); //Uses the struct MAX31856 defined here and reads in all registers
 	MAX31856Calculate(); //Uses the registers in MAX31856.REG.* to calculate all of the doubles
+In the voltage modes (TCTYPE 8-15) LTCT is NAN, the thermocouple input voltage comes from MAX31856LTCVolts() instead
 */
 void MAX31856Calculate(struct MAX31856_REG_Struct * M = &MAX31856) {
 	M->CJHF = double(M->REG.CJHF);
@@ -204,274 +313,546 @@ void MAX31856Calculate(struct MAX31856_REG_Struct * M = &MAX31856) {
 	M->LTHFT = double(M->REG.LTHFT.LTHFT) * 0.0625;
 	M->LTLFT = double(M->REG.LTLFT.LTLFT) * 0.0625;
 	M->CJTO = double(M->REG.CJTO) * 0.0625;
-	M->CJT = double(M->REG.CJT.CJT) * 0.00390625;
-	int32_t temp = M->REG.LTC.H << 16 | M->REG.LTC.M << 8 | M->REG.LTC.L;
-	if (temp & 0x800000) temp |= 0xFF000000;  // fix sign
-	temp >>= 5;  // bottom 5 bits are unused
-	M->LTCT = double(temp) * 0.0078125;
+	M->CJT = MAX31856CJTToDouble(M->REG.CJT.CJT);
+	if (MAX31856VoltageGain(M)) M->LTCT = NAN; //LTC is a voltage, see MAX31856CalculateLinearized() for a temperature
+	else M->LTCT = MAX31856LTCToDouble(MAX31856DecodeLTC(&M->REG));
+} //===============================================================================================
+
+/*
+Sinks for the register map dumps below.  Every dump is written straight to a Print (Serial, a telnet WiFiClient, ...)
+so no String temporaries or heap are involved.
+MAX31856BufferPrint collects a dump into a fixed caller supplied buffer, always NULL terminated.  If the buffer is too small
+the output is truncated and Overflow is set rather than running off the end.  The MAX31856_*_MAX_LEN defines are the
+worst case number of characters each dump can produce, not counting the terminating NULL.
+MAX31856StringPrint appends to a String, it is what the older MAX31856GetREGMapString* functions use.  Reserve the
+String to the MAX_LEN first and a dump is a single allocation (allocation counts and timings: extras/host/MAX31856DumpCheck.cpp).
+Typical Use:
+	char Buffer[MAX31856_CR0_MAX_LEN + 1];
+	MAX31856BufferPrint B(Buffer, sizeof(Buffer));
+	MAX31856PrintREGMapCR0(B);
+	client.write((const uint8_t *)Buffer, B.Length);
+*/
+#define MAX31856_REGMAP_MAX_LEN		383
+#define MAX31856_CR0_MAX_LEN		381
+#define MAX31856_CR1_MAX_LEN		161
+#define MAX31856_MASK_MAX_LEN		207
+#define MAX31856_FAULT_MAX_LEN		897
+#define MAX31856_TEMP_MAX_LEN		440
+class MAX31856BufferPrint : public Print {
+public:
+	char * Buffer;
+	size_t Size;	//Including the NULL terminator
+	size_t Length;	//Characters written so far
+	bool Overflow;	//Set if anything was dropped
+	MAX31856BufferPrint(char * B, size_t S) : Buffer(B), Size(S), Length(0), Overflow(false) {
+		if (Size > 0) Buffer[0] = 0;
+	}
+	size_t write(uint8_t c) {
+		if (Length + 1 >= Size) { Overflow = true; return 0; }
+		Buffer[Length++] = c;
+		Buffer[Length] = 0;
+		return 1;
+	}
+};
+class MAX31856StringPrint : public Print {
+public:
+	String * s;
+	MAX31856StringPrint(String &Str) : s(&Str) {}
+	using Print::write;
+	size_t write(uint8_t c) {
+		*s += char(c);
+		return 1;
+	}
+	size_t write(const uint8_t * Data, size_t Length) {
+		s->reserve(s->length() + Length); //One allocation per print rather than one per character
+		for (size_t i = 0; i < Length; i++) *s += char(Data[i]);
+		return Length;
+	}
+};
+
+void MAX31856PrintIndent(Print &p, const __FlashStringHelper * s, uint8_t NumOfTabs) { //Same layout as StringIndent()
+	uint8_t StringLength = strlen_P((PGM_P)s);
+	uint8_t ColumnNumber = NumOfTabs * TABLENGTH;
+	uint8_t Difference = ColumnNumber - StringLength;
+	uint8_t NumOfTabsToAdd = Difference / TABLENGTH;
+	if (StringLength % TABLENGTH != 0) NumOfTabsToAdd++;
+	p.print(s);
+	for (int i = 0; i < NumOfTabsToAdd; i++) {
+		p.print('\t');
+	}
+} //===============================================================================================
+void MAX31856PrintBinaryAndHex(Print &p, uint8_t b) { //Same text as ByteToBinaryAndHex()
+	char Buffer[14];
+	for (uint8_t i = 0; i < 8; i++) {
+		Buffer[i] = bitRead(b, 7 - i) ? '1' : '0';
+	}
+	Buffer[8] = ' ';
+	Buffer[9] = '0';
+	Buffer[10] = 'x';
+	Buffer[11] = "0123456789abcdef"[b >> 4];
+	Buffer[12] = "0123456789abcdef"[b & 0x0F];
+	Buffer[13] = 0;
+	p.print(Buffer);
+} //===============================================================================================
+void MAX31856PrintFloat(Print &p, double Value, uint8_t Decimals) { //Same text as String(Value, Decimals)
+	char Buffer[24];
+	p.print(dtostrf(Value, Decimals + 2, Decimals, Buffer));
 } //===============================================================================================
 
 /*
-Get a String that can be printed out to UART or telnet to quickly display the registers in a human readable format
+Print the registers in a human readable format, or append them to a String
 Typical Use:
 	MAX31856ReadRegisters();
+	MAX31856PrintREGMap(Serial);
+	OR
 	String s;
 	MAX31856GetREGMapString(s);
 	Serial.print(s);
 
 */
+void MAX31856PrintREGMap(Print &p, struct MAX31856_REG_Struct * M = &MAX31856) {
+	p.print(F("Register Memory Map:\r\n"));
+	p.print(F("\r\n	CR0:	")); MAX31856PrintBinaryAndHex(p, M->REG.CR0.WORD);
+	p.print(F("\r\n	CR1:	")); MAX31856PrintBinaryAndHex(p, M->REG.CR1.WORD);
+	p.print(F("\r\n	MASK:	")); MAX31856PrintBinaryAndHex(p, M->REG.MASK.WORD);
+	p.print(F("\r\n	CJHF:	")); MAX31856PrintBinaryAndHex(p, (uint8_t)M->REG.CJHF);
+	p.print(F("\r\n	CJLF:	")); MAX31856PrintBinaryAndHex(p, (uint8_t)M->REG.CJLF);
+	p.print(F("\r\n	LTHFTH:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTHFT.H);
+	p.print(F("\r\n	LTHFTL:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTHFT.L);
+	p.print(F("\r\n	LTLFTH:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTLFT.H);
+	p.print(F("\r\n	LTLFTL:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTLFT.L);
+	p.print(F("\r\n	CJTO:	")); MAX31856PrintBinaryAndHex(p, (uint8_t)M->REG.CJTO);
+	p.print(F("\r\n	CJTH:	")); MAX31856PrintBinaryAndHex(p, M->REG.CJT.H);
+	p.print(F("\r\n	CJTL:	")); MAX31856PrintBinaryAndHex(p, M->REG.CJT.L);
+	p.print(F("\r\n	LTCBH:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTC.H);
+	p.print(F("\r\n	LTCBM:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTC.M);
+	p.print(F("\r\n	LTCBL:	")); MAX31856PrintBinaryAndHex(p, M->REG.LTC.L);
+	p.print(F("\r\n	SR:	")); MAX31856PrintBinaryAndHex(p, M->REG.SR.WORD);
+	p.print(F("\r\n"));
+} //===============================================================================================
 void MAX31856GetREGMapString(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
-	s += F("Register Memory Map:\r\n");
-	s += F("\r\n	CR0:	"); s += ByteToBinaryAndHex(M->REG.CR0.WORD);
-	s += F("\r\n	CR1:	"); s += ByteToBinaryAndHex(M->REG.CR1.WORD);
-	s += F("\r\n	MASK:	"); s += ByteToBinaryAndHex(M->REG.MASK.WORD);
-	s += F("\r\n	CJHF:	"); s += ByteToBinaryAndHex((uint8_t)M->REG.CJHF);
-	s += F("\r\n	CJLF:	"); s += ByteToBinaryAndHex((uint8_t)M->REG.CJLF);
-	s += F("\r\n	LTHFTH:	"); s += ByteToBinaryAndHex(M->REG.LTHFT.H);
-	s += F("\r\n	LTHFTL:	"); s += ByteToBinaryAndHex(M->REG.LTHFT.L);
-	s += F("\r\n	LTLFTH:	"); s += ByteToBinaryAndHex(M->REG.LTLFT.H);
-	s += F("\r\n	LTLFTL:	"); s += ByteToBinaryAndHex(M->REG.LTLFT.L);
-	s += F("\r\n	CJTO:	"); s += ByteToBinaryAndHex((uint8_t)M->REG.CJTO);
-	s += F("\r\n	CJTH:	"); s += ByteToBinaryAndHex(M->REG.CJT.H);
-	s += F("\r\n	CJTL:	"); s += ByteToBinaryAndHex(M->REG.CJT.L);
-	s += F("\r\n	LTCBH:	"); s += ByteToBinaryAndHex(M->REG.LTC.H);
-	s += F("\r\n	LTCBM:	"); s += ByteToBinaryAndHex(M->REG.LTC.M);
-	s += F("\r\n	LTCBL:	"); s += ByteToBinaryAndHex(M->REG.LTC.L);
-	s += F("\r\n	SR:	"); s += ByteToBinaryAndHex(M->REG.SR.WORD);
-	s += F("\r\n");
-} //===============================================================================================
-
-/*
-Get a String table that can be printed out to UART or telnet to quickly display Config Register 0 in a human readable format
+	MAX31856StringPrint p(s);
+	MAX31856PrintREGMap(p, M);
+} //===============================================================================================
+
+/*
+Print a table of Config Register 0 in a human readable format, or append it to a String
 Typical Use:
 	MAX31856ReadRegisters(); 
+	MAX31856PrintREGMapCR0(Serial);
+	OR
 	String s;
 	MAX31856GetREGMapStringCR0(s);
 	Serial.print(s);
 */
-void MAX31856GetREGMapStringCR0(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
-	s += F("CR0 (Configuration Register)\r\n");
-	s += StringIndent(F("	MODE"), 2);			(MAX31856.REG.CR0.CMODE) ? s += F("Continuous Conversion Mode") : s += F("Normally Off (One Shot)	*Default"); s += F("\r\n");
-	s += StringIndent(F("	1SHOT"), 2);		
-		if (MAX31856.REG.CR0.CMODE) {//if continuous conversion this does nothing
-			s += F("N/A: No effect in Continuous Conversion Mode");
+void MAX31856PrintREGMapCR0(Print &p, struct MAX31856_REG_Struct * M = &MAX31856) {
+	p.print(F("CR0 (Configuration Register)\r\n"));
+	MAX31856PrintIndent(p, F("	MODE"), 2);			p.print((M->REG.CR0.CMODE) ? F("Continuous Conversion Mode") : F("Normally Off (One Shot)	*Default")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	1SHOT"), 2);
+		if (M->REG.CR0.CMODE) {//if continuous conversion this does nothing
+			p.print(F("N/A: No effect in Continuous Conversion Mode"));
 		}
 		else {
-			(MAX31856.REG.CR0.ONESHOT) ? s += F("Conversion ready or active") : s += F("No conversion active	*Default");
-			s += F("\r\n");
-		}	
-	s += StringIndent(F("	OCFAULT"), 2);
-		if (MAX31856.REG.CR0.OCFAULT0 ==false && MAX31856.REG.CR0.OCFAULT1 == false) {
-			s += F("Open Circuit Detection DISABLED");
+			p.print((M->REG.CR0.ONESHOT) ? F("Conversion ready or active") : F("No conversion active	*Default"));
+			p.print(F("\r\n"));
+		}
+	MAX31856PrintIndent(p, F("	OCFAULT"), 2);
+		if (M->REG.CR0.OCFAULT0 == false && M->REG.CR0.OCFAULT1 == false) {
+			p.print(F("Open Circuit Detection DISABLED"));
 		}
-		else if (MAX31856.REG.CR0.OCFAULT0 == true && MAX31856.REG.CR0.OCFAULT1 == false) {	
-			s += F("Open Circuit Detection ENABLED. Fault Detection Time ~");  (MAX31856.REG.CR0.CJ) ? s += F("13.3ms-15ms") : s += F("40ms-44ms");		
+		else if (M->REG.CR0.OCFAULT0 == true && M->REG.CR0.OCFAULT1 == false) {
+			p.print(F("Open Circuit Detection ENABLED. Fault Detection Time ~"));  p.print((M->REG.CR0.CJ) ? F("13.3ms-15ms") : F("40ms-44ms"));
 		}
-		else if (MAX31856.REG.CR0.OCFAULT0 == false && MAX31856.REG.CR0.OCFAULT1 == true) {
-			s += F("Open Circuit Detection ENABLED. Fault Detection Time ~");  (MAX31856.REG.CR0.CJ) ? s += F("33.4ms-37ms") : s += F("60ms-66ms");
+		else if (M->REG.CR0.OCFAULT0 == false && M->REG.CR0.OCFAULT1 == true) {
+			p.print(F("Open Circuit Detection ENABLED. Fault Detection Time ~"));  p.print((M->REG.CR0.CJ) ? F("33.4ms-37ms") : F("60ms-66ms"));
 		}
-		else if (MAX31856.REG.CR0.OCFAULT0 == true && MAX31856.REG.CR0.OCFAULT1 == true) {
-			s += F("Open Circuit Detection ENABLED. Fault Detection Time ~");  (MAX31856.REG.CR0.CJ) ? s += F("113.4ms-125ms") : s += F("140ms-154ms");
+		else if (M->REG.CR0.OCFAULT0 == true && M->REG.CR0.OCFAULT1 == true) {
+			p.print(F("Open Circuit Detection ENABLED. Fault Detection Time ~"));  p.print((M->REG.CR0.CJ) ? F("113.4ms-125ms") : F("140ms-154ms"));
 		}
-		s += F("\r\n");
-	s += StringIndent(F("	CJ"), 2);			(MAX31856.REG.CR0.CJ) ? s += F("CJ DISABLED") : s += F("CJ ENABLED	*Default"); s += F("\r\n");
-	s += StringIndent(F("	FAULT"), 2);		(MAX31856.REG.CR0.FAULT) ? s += F("FAULT pin and fault bits are latched and requires a FAULTCLR cmd") : s += F("FAULT pin and fault bits are automatically Reset	*Default"); s += F("\r\n");
-	s += StringIndent(F("	FAULTCLR"), 2);		(MAX31856.REG.CR0.FAULTCLR) ? s += F("Set to clear faults") : s += F("N/A: No effect in FAULT mode 0	*Default"); s += F("\r\n");
-	s += StringIndent(F("	50/60Hz"), 2);		(MAX31856.REG.CR0.Hz50_60) ? s += F("50Hz notch filter") : s += F("60hz notch filter	*Default"); s += F("\r\n");
+		p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	CJ"), 2);			p.print((M->REG.CR0.CJ) ? F("CJ DISABLED") : F("CJ ENABLED	*Default")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	FAULT"), 2);		p.print((M->REG.CR0.FAULT) ? F("FAULT pin and fault bits are latched and requires a FAULTCLR cmd") : F("FAULT pin and fault bits are automatically Reset	*Default")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	FAULTCLR"), 2);		p.print((M->REG.CR0.FAULTCLR) ? F("Set to clear faults") : F("N/A: No effect in FAULT mode 0	*Default")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	50/60Hz"), 2);		p.print((M->REG.CR0.Hz50_60) ? F("50Hz notch filter") : F("60hz notch filter	*Default")); p.print(F("\r\n"));
 
 } //===============================================================================================
+void MAX31856GetREGMapStringCR0(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	MAX31856StringPrint p(s);
+	MAX31856PrintREGMapCR0(p, M);
+} //===============================================================================================
 
 /*
-Get a String table that can be printed out to UART or telnet to quickly display Config Register 1 in a human readable format
+Print a table of Config Register 1 in a human readable format, or append it to a String
 Typical Use:
 	MAX31856ReadRegisters();
+	MAX31856PrintREGMapCR1(Serial);
+	OR
 	String s;
 	MAX31856GetREGMapStringCR1(s);
 	Serial.print(s);
 */
-void MAX31856GetREGMapStringCR1(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+void MAX31856PrintREGMapCR1(Print &p, struct MAX31856_REG_Struct * M = &MAX31856) {
 
-	s += F("CR1 (Configuration Register)\r\n");
-	uint8_t AveragedSamples;
+	p.print(F("CR1 (Configuration Register)\r\n"));
 	if (M->REG.CR1.AVGSEL == 0) {
-		s += F("	AVGSEL: Sample Averaging DISABLED\r\n"); AveragedSamples = 1;
+		p.print(F("	AVGSEL: Sample Averaging DISABLED\r\n"));
 	} else if (M->REG.CR1.AVGSEL == 1) {
-		s += F("	AVGSEL: 2 Samples Averaged\r\n"); AveragedSamples = 2;
+		p.print(F("	AVGSEL: 2 Samples Averaged\r\n"));
 	}
 	else if (M->REG.CR1.AVGSEL == 2) {
-		s += F("	AVGSEL: 4 Samples Averaged\r\n"); AveragedSamples = 4;
+		p.print(F("	AVGSEL: 4 Samples Averaged\r\n"));
 	}
 	else if (M->REG.CR1.AVGSEL == 3) {
-		s += F("	AVGSEL: 8 Samples Averaged\r\n"); AveragedSamples = 8;
+		p.print(F("	AVGSEL: 8 Samples Averaged\r\n"));
 	}
 	else if (M->REG.CR1.AVGSEL >= 4 && M->REG.CR1.AVGSEL <= 7) {
-		s += F("	AVGSEL: 16 Sample Averaging Enabled\r\n");	AveragedSamples = 16;
+		p.print(F("	AVGSEL: 16 Sample Averaging Enabled\r\n"));
 	}
 	else {
-		s += F("	AVGSEL: ERROR detecing sample averaging status\r\n"); AveragedSamples = 0;
+		p.print(F("	AVGSEL: ERROR detecing sample averaging status\r\n"));
 	}
 
 	float Tconv;
 	float TconvMax;
-	if (M->REG.CR0.CMODE) { //automatic conversion
-		if (M->REG.CR0.Hz50_60) { //50hz
-			Tconv = 98.0		+ float(AveragedSamples - 1) * 20.0;
-			TconvMax = 110.0	+ float(AveragedSamples - 1) * 20.0;
-		}
-		else {//60hz
-			Tconv = 82.0		+ float(AveragedSamples - 1) * 16.67;
-			TconvMax = 90.0		+ float(AveragedSamples - 1) * 16.67;
-		}
-	}
-	else {//one shot conversion
-		if (M->REG.CR0.Hz50_60) { //50hz
-			Tconv = 169.0		+ float(AveragedSamples - 1) * 40.0;
-			TconvMax = 185.0	+ float(AveragedSamples - 1) * 40.0;
-		}
-		else {//60hz
-			Tconv = 143.0		+ float(AveragedSamples - 1) * 33.3;
-			TconvMax = 155.0	+ float(AveragedSamples - 1) * 33.3;
-		}
-	}
-	s += F("	Estimated Conversion Time:	"); s += String(Tconv); s += F("ms typical, ");  s += String(TconvMax); s += F("ms Maximum\r\n");
-	s += F("	TC Type:	");
-	if (M->REG.CR1.TCTYPE == 0)	s += F("B");
-	if (M->REG.CR1.TCTYPE == 1)	s += F("E");
-	if (M->REG.CR1.TCTYPE == 2)	s += F("J");
-	if (M->REG.CR1.TCTYPE == 3)	s += F("K");
-	if (M->REG.CR1.TCTYPE == 4)	s += F("N");
-	if (M->REG.CR1.TCTYPE == 5)	s += F("R");
-	if (M->REG.CR1.TCTYPE == 6)	s += F("S");
-	if (M->REG.CR1.TCTYPE == 7)	s += F("T");
-	if (M->REG.CR1.TCTYPE >= 8 && M->REG.CR1.TCTYPE <= 11)	s += F("Voltage 8 X gain");
-	if (M->REG.CR1.TCTYPE >= 12 && M->REG.CR1.TCTYPE <= 15)	s += F("Voltage 32 X gain");
-	s += F("\r\n");
+	MAX31856ConversionTime(&Tconv, &TconvMax, M);
+	p.print(F("	Estimated Conversion Time:	")); MAX31856PrintFloat(p, Tconv, 2); p.print(F("ms typical, ")); MAX31856PrintFloat(p, TconvMax, 2); p.print(F("ms Maximum\r\n"));
+	p.print(F("	TC Type:	"));
+	if (M->REG.CR1.TCTYPE == 0)	p.print(F("B"));
+	if (M->REG.CR1.TCTYPE == 1)	p.print(F("E"));
+	if (M->REG.CR1.TCTYPE == 2)	p.print(F("J"));
+	if (M->REG.CR1.TCTYPE == 3)	p.print(F("K"));
+	if (M->REG.CR1.TCTYPE == 4)	p.print(F("N"));
+	if (M->REG.CR1.TCTYPE == 5)	p.print(F("R"));
+	if (M->REG.CR1.TCTYPE == 6)	p.print(F("S"));
+	if (M->REG.CR1.TCTYPE == 7)	p.print(F("T"));
+	if (M->REG.CR1.TCTYPE >= 8 && M->REG.CR1.TCTYPE <= 11)	p.print(F("Voltage 8 X gain"));
+	if (M->REG.CR1.TCTYPE >= 12 && M->REG.CR1.TCTYPE <= 15)	p.print(F("Voltage 32 X gain"));
+	p.print(F("\r\n"));
+} //===============================================================================================
+void MAX31856GetREGMapStringCR1(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	MAX31856StringPrint p(s);
+	MAX31856PrintREGMapCR1(p, M);
 } //===============================================================================================
 
 /*
-Get a String table that can be printed out to UART or telnet to quickly display the Fault Mask Register in a human readable format
+Print a table of the Fault Mask Register in a human readable format, or append it to a String
 Typical Use:
 	MAX31856ReadRegisters();
+	MAX31856PrintREGMapMASK(Serial);
+	OR
 	String s;
 	MAX31856GetREGMapStringMASK(s);
 	Serial.print(s);
 */
+void MAX31856PrintREGMapMASK(Print &p, struct MAX31856_REG_Struct * M = &MAX31856) {
+	p.print(F("MASK (Fault Mask Register)"));
+	p.print(F("\r\n	(bit5)CJ High FAULT Mask =	")); p.print(M->REG.MASK.CJ_HIGH_FAULT_MASK);
+	p.print(F("\r\n	(bit4)CJ Low FAULT Mask =	")); p.print(M->REG.MASK.CJ_LOW_FAULT_MASK);
+	p.print(F("\r\n	(bit3)TC High FAULT Mask =	")); p.print(M->REG.MASK.TC_HIGH_FAULT_MASK);
+	p.print(F("\r\n	(bit2)TC Low FAULT Mask =	")); p.print(M->REG.MASK.TC_LOW_FAULT_MASK);
+	p.print(F("\r\n	(bit1)OV/UV FAULT Mask =	")); p.print(M->REG.MASK.OV_UV_FAULT_MASK);
+	p.print(F("\r\n	(bit0)Open FAULT Mask =	")); p.print(M->REG.MASK.OPEN_FAULT_MASK);
+	p.print(F("\r\n"));
+} //===============================================================================================
 void MAX31856GetREGMapStringMASK(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
-	s += F("MASK (Fault Mask Register)");
-	s += F("\r\n	(bit5)CJ High FAULT Mask =	"); s += M->REG.MASK.CJ_HIGH_FAULT_MASK;
-	s += F("\r\n	(bit4)CJ Low FAULT Mask =	"); s += M->REG.MASK.CJ_LOW_FAULT_MASK; 
-	s += F("\r\n	(bit3)TC High FAULT Mask =	"); s += M->REG.MASK.TC_HIGH_FAULT_MASK;
-	s += F("\r\n	(bit2)TC Low FAULT Mask =	"); s += M->REG.MASK.TC_LOW_FAULT_MASK; 
-	s += F("\r\n	(bit1)OV/UV FAULT Mask =	"); s += M->REG.MASK.OV_UV_FAULT_MASK;
-	s += F("\r\n	(bit0)Open FAULT Mask =	"); s += M->REG.MASK.OPEN_FAULT_MASK;
-	s += F("\r\n");
+	MAX31856StringPrint p(s);
+	MAX31856PrintREGMapMASK(p, M);
 } //===============================================================================================
 
 /*
-Get a String table that can be printed out to UART or telnet to quickly display the Fault Register in a human readable format
+Print a table of the Fault Register in a human readable format, or append it to a String
 Typical Use:
 	MAX31856ReadRegisters();
+	MAX31856PrintREGMapFAULT(Serial);
+	OR
 	String s;
 	MAX31856GetREGMapStringFAULT(s);
 	Serial.print(s);
 */
+void MAX31856PrintREGMapFAULT(Print &p, struct MAX31856_REG_Struct * M = &MAX31856) {
+	p.print(F("Fault Status Register SR)\r\n"));
+	MAX31856PrintIndent(p, F("	CJ Range"), 2);		p.print((M->REG.SR.CJ_Range) ? F("	ERROR: The Cold-Junction temperature is outside of the normal operating range.") : F("	OK: The Cold-Junction temperature is within the normal operating range (-55C to +125C for types E,J, K, N, and T; -50C to + 125C for types R and S; 0 to 125C for type B).)")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	TC Range"), 2);		p.print((M->REG.SR.TC_Range) ? F("	ERROR: The Thermocouple Hot Junction temperature is outside of the normal operating range.") : F("	OK: The Thermocouple Hot Junction temperature is within the normal operating range")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	CJHIGH"), 2);		p.print((M->REG.SR.CJHIGH) ? F("	ERROR: The Thermocouple Hot Junction temperature is outside of the normal operating range.") : F("	OK: The Cold-Junction temperature is higher than the cold-junction temperature high threshold")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	CJLOW"), 2);		p.print((M->REG.SR.CJLOW) ? F("	ERROR: The Cold-Junction temperature is lower than the cold-junction temperature low threshold") : F("	OK: The Cold-Junction temperature is at or higher than the cold-junction temperature low threshold ")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	TCHIGH"), 2);		p.print((M->REG.SR.TCHIGH) ? F("	ERROR: The Thermocouple Temperature is higher than the thermocouple temperature high threshold.") : F("	OK: The Thermocouple Temperature is higher than the thermocouple temperature high threshold ")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	TCLOW"), 2);		p.print((M->REG.SR.TCLOW) ? F("	ERROR: Thermocouple temperature is lower than the thermocouple temperature low threshold. ") : F("	OK: Thermocouple temperature is at or higher than the thermocouple temperature low threshold ")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	OVUV"), 2);			p.print((M->REG.SR.OVUV) ? F("	ERROR: The input voltage is negative or greater than VDD") : F("	OK: The input voltage is positive and less than VDD")); p.print(F("\r\n"));
+	MAX31856PrintIndent(p, F("	OPEN"), 2);			p.print((M->REG.SR.OPEN) ? F("	ERROR: An open circuit such as broken thermocouple wires has been detected. ") : F("	OK: No open circuit or broken thermocouple wires are detected ")); p.print(F("\r\n"));
+} //===============================================================================================
 void MAX31856GetREGMapStringFAULT(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
-	s += F("Fault Status Register SR)\r\n");
-	s += StringIndent(F("	CJ Range"), 2);		(M->REG.SR.CJ_Range) ? s += F("	ERROR: The Cold-Junction temperature is outside of the normal operating range.") : s += F("	OK: The Cold-Junction temperature is within the normal operating range (-55C to +125C for types E,J, K, N, and T; -50C to + 125C for types R and S; 0 to 125C for type B).)"); s += F("\r\n");
-	s += StringIndent(F("	TC Range"), 2);		(M->REG.SR.TC_Range) ? s += F("	ERROR: The Thermocouple Hot Junction temperature is outside of the normal operating range.") : s += F("	OK: The Thermocouple Hot Junction temperature is within the normal operating range"); s += F("\r\n");
-	s += StringIndent(F("	CJHIGH"), 2);		(M->REG.SR.CJHIGH) ? s += F("	ERROR: The Thermocouple Hot Junction temperature is outside of the normal operating range.") : s += F("	OK: The Cold-Junction temperature is higher than the cold-junction temperature high threshold"); s += F("\r\n");
-	s += StringIndent(F("	CJLOW"), 2);		(M->REG.SR.CJLOW) ? s += F("	ERROR: The Cold-Junction temperature is lower than the cold-junction temperature low threshold") : s += F("	OK: The Cold-Junction temperature is at or higher than the cold-junction temperature low threshold "); s += F("\r\n");
-	s += StringIndent(F("	TCHIGH"), 2);		(M->REG.SR.TCHIGH) ? s += F("	ERROR: The Thermocouple Temperature is higher than the thermocouple temperature high threshold.") : s += F("	OK: The Thermocouple Temperature is higher than the thermocouple temperature high threshold "); s += F("\r\n");
-	s += StringIndent(F("	TCLOW"), 2);		(M->REG.SR.TCLOW) ? s += F("	ERROR: Thermocouple temperature is lower than the thermocouple temperature low threshold. ") : s += F("	OK: Thermocouple temperature is at or higher than the thermocouple temperature low threshold "); s += F("\r\n");
-	s += StringIndent(F("	OVUV"), 2);			(M->REG.SR.OVUV) ? s += F("	ERROR: The input voltage is negative or greater than VDD") : s += F("	OK: The input voltage is positive and less than VDD"); s += F("\r\n");
-	s += StringIndent(F("	OPEN"), 2);			(M->REG.SR.OPEN) ? s += F("	ERROR: An open circuit such as broken thermocouple wires has been detected. ") : s += F("	OK: No open circuit or broken thermocouple wires are detected "); s += F("\r\n");
+	MAX31856StringPrint p(s);
+	MAX31856PrintREGMapFAULT(p, M);
 } //===============================================================================================
 
 /*
-Get a String table that can be printed out to UART or telnet to quickly display all of the other registers in a human readable format
+Print all of the other registers in a human readable format, or append them to a String
 Typical Use:
 	MAX31856ReadRegisters(); //Uses the struct MAX31856 defined here and reads in all registers
 	MAX31856Calculate(); //Uses the registers in MAX31856.REG.* to calculate all of the doubles
+	MAX31856PrintREGMapTemp(Serial);
+	OR
 	String s;
 	MAX31856GetREGMapStringTemp(s); //Uses the registers in MAX31856.REG.* to calculate all of the doubles
 	Serial.print(s);
 */
+void MAX31856PrintREGMapTemp(Print &p, struct MAX31856_REG_Struct * M = &MAX31856) {
+	p.print(F("CJHF (Cold Junction High Fault Threshold): ")); MAX31856PrintFloat(p, M->CJHF, 2); p.print(F("C\r\n"));
+	p.print(F("CJLF (Cold Junction Low Fault Threshold): ")); MAX31856PrintFloat(p, M->CJLF, 2); p.print(F("C\r\n"));
+	p.print(F("LTHFTH + LTHFTL (Linearized Temperature High Fault Threshold MSB + LSB): ")); MAX31856PrintFloat(p, M->LTHFT, 3); p.print(F("C\r\n"));
+	p.print(F("LTLFTH + LTLFTL (Linearized Temperature Low Fault Threshold MSB + LSB): ")); MAX31856PrintFloat(p, M->LTLFT, 3); p.print(F("C\r\n"));
+	p.print(F("CJTO (Cold Junction Temperature Offset): ")); MAX31856PrintFloat(p, M->CJTO, 3); p.print(F("C\r\n"));
+	p.print(F("CJTH + CJTL (Cold Junction Temperature): ")); MAX31856PrintFloat(p, M->CJT, 3); p.print(F("C\r\n"));
+	if (MAX31856VoltageGain(M)) {
+		p.print(F("LTCMH + LTCBM + LTCBL (Thermocouple Voltage): ")); MAX31856PrintFloat(p, MAX31856LTCVolts(M) * 1000.0, 4); p.print(F("mV\r\n"));
+	}
+	else {
+		p.print(F("LTCMH + LTCBM + LTCBL (Linearized TC Temperature): ")); MAX31856PrintFloat(p, M->LTCT, 4); p.print(F("C\r\n"));
+	}
+} //===============================================================================================
 void MAX31856GetREGMapStringTemp(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
-	s += F("CJHF (Cold Junction High Fault Threshold): "); s += M->CJHF; s += F("C\r\n");
-	s += F("CJLF (Cold Junction Low Fault Threshold): "); s += M->CJLF; s += F("C\r\n");
-	s += F("LTHFTH + LTHFTL (Linearized Temperature High Fault Threshold MSB + LSB): ");   s += String(M->LTHFT, 3); s += F("C\r\n");
-	s += F("LTLFTH + LTLFTL (Linearized Temperature Low Fault Threshold MSB + LSB): ");   s += String(M->LTLFT, 3); s += F("C\r\n");
-	s += F("CJTO (Cold Junction Temperature Offset): "); s += String(M->CJTO, 3); s += F("C\r\n");
-	s += F("CJTH + CJTL (Cold Junction Temperature): "); s += String(M->CJT, 3); s += F("C\r\n");
-	s += F("LTCMH + LTCBM + LTCBL (Linearized TC Temperature): "); s += String(M->LTCT, 4); s += F("C\r\n");
+	MAX31856StringPrint p(s);
+	MAX31856PrintREGMapTemp(p, M);
+} //===============================================================================================
+
+/*
+Running count of SPI transactions and bytes clocked by this file, across every device.
+Zero it, run a workload, and read it back to see what the bus is actually spending.
+Typical Use:
+	MAX31856SPICounters.Transactions = 0; MAX31856SPICounters.Bytes = 0;
+	for (uint8_t i = 0; i < 100; i++) MAX31856ReadTemperature();
+	Serial.println(MAX31856SPICounters.Bytes); //500, vs 1700 for 100 MAX31856ReadRegisters()
+*/
+struct MAX31856_SPICounters_Struct {	//Also counted from the async pipeline ISR, read it with interrupts masked on 8 bit parts
+	volatile uint32_t Transactions;
+	volatile uint32_t Bytes;
+};
+MAX31856_SPICounters_Struct MAX31856SPICounters;
+
+/*
+The SPI transport every register access goes through.  On the Arduino it is the SPI library, on a host build (MAX31856_HOST,
+see extras/host/MAX31856Host.h) it is whatever MAX31856Transport is pointed at, usually the simulator in extras/host/MAX31856Sim.h.
+	Begin/End		wrap a transaction, SPI.beginTransaction()/SPI.endTransaction()
+	Select			drive a chip select, Selected = true pulls it low
+	Transfer		clock Length bytes out of BufferOut while storing what comes back in BufferIn (NULL if not wanted)
+	TransferAsync	optional, start the same transfer by DMA or interrupt and return straight away, calling Done(Context) once the
+					last byte is in (Done may be called from an ISR).  NULL if the platform has no such driver, in which case
+					the async pipeline falls back to Transfer
+*/
+struct MAX31856_Transport_Struct {
+	void (*Begin)();
+	void (*End)();
+	void (*Select)(uint8_t CSPin, bool Selected);
+	void (*Transfer)(const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length);
+	void (*TransferAsync)(const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length, void (*Done)(void * Context), void * Context);
+};
+#ifndef MAX31856_HOST
+void MAX31856SPIBegin() {
+	SPI.beginTransaction(MAX31856_SPISettings);
+} //===============================================================================================
+void MAX31856SPIEnd() {
+	SPI.endTransaction();
+} //===============================================================================================
+void MAX31856SPISelect(uint8_t CSPin, bool Selected) {
+	digitalWrite(CSPin, Selected ? LOW : HIGH);
+} //===============================================================================================
+void MAX31856SPITransfer(const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length) {
+	SPI.transferBytes(BufferOut, BufferIn, Length); //Note: SPI.transferBytes(MOSI, MISO, SIZE)
+} //===============================================================================================
+MAX31856_Transport_Struct MAX31856SPITransport = { MAX31856SPIBegin, MAX31856SPIEnd, MAX31856SPISelect, MAX31856SPITransfer, NULL };
+MAX31856_Transport_Struct * MAX31856Transport = &MAX31856SPITransport;
+#else
+MAX31856_Transport_Struct * MAX31856Transport = NULL; //Must be set before the first register access
+#endif
+
+/*
+Blocking transfers and the async pipeline (MAX31856AsyncStart() from a DRDY ISR) share the bus.  MAX31856BusClaim() waits for
+an async transfer on the bus to finish and marks the bus busy, so a DRDY that comes in meanwhile is queued rather than cutting
+into the blocking transfer.  MAX31856BusRelease() counts the transfer and starts whatever queued up.  Every blocking access in
+this file goes through them, so they must not be called from an ISR
+*/
+struct MAX31856_Async_Struct;
+struct MAX31856_Async_Struct * volatile MAX31856AsyncActive = NULL;	//Pipeline whose transfer is on the bus
+volatile bool MAX31856BusBlocking = false;							//A blocking transfer is on the bus
+void MAX31856AsyncKickPending();
+
+void MAX31856BusClaim() {
+	for (;;) {
+		noInterrupts();
+		if (MAX31856AsyncActive == NULL) break;
+		interrupts();
+	}
+	MAX31856BusBlocking = true;
+	interrupts();
+} //===============================================================================================
+void MAX31856BusRelease(uint16_t Length) {
+	noInterrupts();
+	MAX31856SPICounters.Transactions++;
+	MAX31856SPICounters.Bytes += Length;
+	MAX31856BusBlocking = false;
+	MAX31856AsyncKickPending();
+	interrupts();
 } //===============================================================================================
 
+/*
+Clock a buffer in and out of a MAX31856 in a single SPI transaction.  Every register access in this file goes through here.
+If CSPin is MAX31856_NO_PIN the chip select is assumed to be handled outside of this file (single device with CS tied or driven by the caller),
+otherwise CSPin is pulled low for the duration of the transfer.
+Pass NULL for BufferIn on a write where the returned bytes are not needed.
+Typical Use:
+	uint8_t BufferOut[2] = { 0x81, 0x03 }; //Write CR1
+	MAX31856Transfer(CS_PIN, &BufferOut[0], NULL, sizeof(BufferOut));
+*/
+void MAX31856Transfer(uint8_t CSPin, const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length) {
+	MAX31856BusClaim();
+	MAX31856Transport->Begin();
+	if (CSPin != MAX31856_NO_PIN) MAX31856Transport->Select(CSPin, true);
+	MAX31856Transport->Transfer(BufferOut, BufferIn, Length);
+	if (CSPin != MAX31856_NO_PIN) MAX31856Transport->Select(CSPin, false);
+	MAX31856Transport->End();
+	MAX31856BusRelease(Length);
+}//===============================================================================================
+
+/*
+Pack the 12 writable registers (0x00-0x0B) of M into Image in address order
+*/
+void MAX31856PackConfig(struct MAX31856_REG_Struct * M, uint8_t * Image) {
+	Image[0] = M->REG.CR0.WORD;
+	Image[1] = M->REG.CR1.WORD;
+	Image[2] = M->REG.MASK.WORD;
+	Image[3] = (uint8_t)M->REG.CJHF;
+	Image[4] = (uint8_t)M->REG.CJLF;
+	Image[5] = M->REG.LTHFT.H;
+	Image[6] = M->REG.LTHFT.L;
+	Image[7] = M->REG.LTLFT.H;
+	Image[8] = M->REG.LTLFT.L;
+	Image[9] = (uint8_t)M->REG.CJTO;
+	Image[10] = M->REG.CJT.H;
+	Image[11] = M->REG.CJT.L;
+}//===============================================================================================
+
+/*
+Pack all 16 registers (0x00-0x0F) of M into Registers in address order, or load M back from them
+*/
+void MAX31856PackRegisters(struct MAX31856_REG_Struct * M, uint8_t * Registers) {
+	MAX31856PackConfig(M, Registers);
+	Registers[12] = M->REG.LTC.H;
+	Registers[13] = M->REG.LTC.M;
+	Registers[14] = M->REG.LTC.L;
+	Registers[15] = M->REG.SR.WORD;
+}//===============================================================================================
+void MAX31856UnpackRegisters(struct MAX31856_REG_Struct * M, const uint8_t * Registers) {
+	M->REG.CR0.WORD		= Registers[0];
+	M->REG.CR1.WORD		= Registers[1];
+	M->REG.MASK.WORD	= Registers[2];
+	M->REG.CJHF			= (int8_t)Registers[3];
+	M->REG.CJLF			= (int8_t)Registers[4];
+	M->REG.LTHFT.H		= Registers[5];
+	M->REG.LTHFT.L		= Registers[6];
+	M->REG.LTLFT.H		= Registers[7];
+	M->REG.LTLFT.L		= Registers[8];
+	M->REG.CJTO			= (int8_t)Registers[9];
+	M->REG.CJT.H		= Registers[10];
+	M->REG.CJT.L		= Registers[11];
+	M->REG.LTC.H		= Registers[12];
+	M->REG.LTC.M		= Registers[13];
+	M->REG.LTC.L		= Registers[14];
+	M->REG.SR.WORD		= Registers[15];
+}//===============================================================================================
+
+/*
+Write Length bytes to consecutive registers starting at Address (0x00-0x0B), relying on the MAX31856 address auto increment.
+Costs Length + 1 bytes on the bus.
+Typical Use:
+	uint8_t CR1 = 0x23;
+	MAX31856WriteRange(CS_PIN, 0x01, &CR1, 1); //2 byte write of CR1 only
+*/
+void MAX31856WriteRange(uint8_t CSPin, uint8_t Address, const uint8_t * Data, uint8_t Length) {
+	uint8_t BufferOut[13];
+	if (Length > 12) Length = 12;
+	BufferOut[0] = 0x80 | Address; //Set bit 7 to signify write
+	memcpy(&BufferOut[1], Data, Length);
+	MAX31856Transfer(CSPin, &BufferOut[0], NULL, Length + 1);
+}//===============================================================================================
+
 /*
 Write the Struct down to the MAX31856
 Typical Use:
 	MAX31856WriteRegisters();
 	OR
 	MAX31856WriteRegisters(&Saved_Configuration); // where Saved_Configuration is data type MAX31856_REG_Struct and perhaps saved to flash memory
+	OR
+	MAX31856WriteRegisters(&Saved_Configuration, CS_PIN); // drive a chip select for one of several MAX31856 on the bus
 */
-void MAX31856WriteRegisters(struct MAX31856_REG_Struct * M = &MAX31856) {	
+void MAX31856WriteRegisters(struct MAX31856_REG_Struct * M = &MAX31856, uint8_t CSPin = MAX31856_NO_PIN) {	
 	//Load up a buffer to send to MAX31856
 	uint8_t BufferOut[13] = { 0 };
 	BufferOut[0] = 0x80;  //Set the Address Word to the first address and set bit 7 to signify write
-	BufferOut[1] = M->REG.CR0.WORD;
-	BufferOut[2] = M->REG.CR1.WORD;
-	BufferOut[3] = M->REG.MASK.WORD;
-	BufferOut[4] = (uint8_t)M->REG.CJHF;
-	BufferOut[5] = (uint8_t)M->REG.CJLF;
-	BufferOut[6] = M->REG.LTHFT.H;
-	BufferOut[7] = M->REG.LTHFT.L;
-	BufferOut[8] = M->REG.LTLFT.H;
-	BufferOut[9] = M->REG.LTLFT.L;
-	BufferOut[10] = (uint8_t)M->REG.CJTO;
-	BufferOut[11] = M->REG.CJT.H;
-	BufferOut[12] = M->REG.CJT.L;
+	MAX31856PackConfig(M, &BufferOut[1]);
 	//The last 4 registers are read only no need to clock these
 
-	SPI.beginTransaction(MAX31856_SPISettings);	
-	SPI.transferBytes(&BufferOut[0], NULL, sizeof(BufferOut)); //Write the entire register image. Note: SPI.transferBytes(MOSI, MISO, SIZE)
-	SPI.endTransaction();
+	MAX31856Transfer(CSPin, &BufferOut[0], NULL, sizeof(BufferOut)); //Write the entire register image
 }//===============================================================================================
 
 /*
 Read in the registers of the MAX31856, and updating the passed in struct (or the root one contained in this file)
 Typical Use:
 	MAX31856ReadRegisters(); //Updates MAX31856 in this file
+	OR
+	MAX31856ReadRegisters(&M, CS_PIN); //Updates M from the MAX31856 selected by CS_PIN
 */
-void MAX31856ReadRegisters(struct MAX31856_REG_Struct * M = &MAX31856) {
+void MAX31856ReadRegisters(struct MAX31856_REG_Struct * M = &MAX31856, uint8_t CSPin = MAX31856_NO_PIN) {
 
 	uint8_t BufferIn[17] = { 0 };
 	uint8_t BufferOut[sizeof(BufferIn)] = { 0 };
-	SPI.beginTransaction(MAX31856_SPISettings);	
-	SPI.transferBytes(&BufferOut[0], &BufferIn[0], sizeof(BufferIn)); //Read up the entire configuration. Note: SPI.transferBytes(MOSI, MISO, SIZE)
-	SPI.endTransaction();
+	MAX31856Transfer(CSPin, &BufferOut[0], &BufferIn[0], sizeof(BufferIn)); //Read up the entire configuration
+
+	MAX31856UnpackRegisters(M, &BufferIn[1]); //BufferIn[0] is whatever was clocked in during the address phase so is useless
+}//===============================================================================================
+
+/*
+Hot path read: only the Linearized TC Temperature and the Fault Status Register (0x0C-0x0F), 5 bytes instead of 17.
+Only M->REG.LTC and M->REG.SR are updated, everything else in M is left alone.
+Typical Use:
+	MAX31856ReadRegisters();	//Once at startup to pick up the configuration
+	...
+	MAX31856ReadTemperature();	//Every conversion after that
+	MAX31856Calculate();
+*/
+void MAX31856ReadTemperature(struct MAX31856_REG_Struct * M = &MAX31856, uint8_t CSPin = MAX31856_NO_PIN) {
+	uint8_t BufferIn[5] = { 0 };
+	uint8_t BufferOut[sizeof(BufferIn)] = { 0 };
+	BufferOut[0] = 0x0C; //Start at LTCBH
+	MAX31856Transfer(CSPin, &BufferOut[0], &BufferIn[0], sizeof(BufferIn));
+
+	M->REG.LTC.H		= BufferIn[1];
+	M->REG.LTC.M		= BufferIn[2];
+	M->REG.LTC.L		= BufferIn[3];
+	M->REG.SR.WORD		= BufferIn[4];
+}//===============================================================================================
+
+/*
+Same as MAX31856ReadTemperature() but starting at the Cold Junction Temperature (0x0A-0x0F), 7 bytes instead of 17.
+Only M->REG.CJT, M->REG.LTC and M->REG.SR are updated
+*/
+void MAX31856ReadCJAndTemperature(struct MAX31856_REG_Struct * M = &MAX31856, uint8_t CSPin = MAX31856_NO_PIN) {
+	uint8_t BufferIn[7] = { 0 };
+	uint8_t BufferOut[sizeof(BufferIn)] = { 0 };
+	BufferOut[0] = 0x0A; //Start at CJTH
+	MAX31856Transfer(CSPin, &BufferOut[0], &BufferIn[0], sizeof(BufferIn));
 
-						//BufferIn[0] is whatever was clocked in during the address phase so is useless
-	M->REG.CR0.WORD		= BufferIn[1];
-	M->REG.CR1.WORD		= BufferIn[2];
-	M->REG.MASK.WORD	= BufferIn[3];
-	M->REG.CJHF			= (int8_t)BufferIn[4];
-	M->REG.CJLF			= (int8_t)BufferIn[5];
-	M->REG.LTHFT.H		= BufferIn[6];
-	M->REG.LTHFT.L		= BufferIn[7];
-	M->REG.LTLFT.H		= BufferIn[8];
-	M->REG.LTLFT.L		= BufferIn[9];
-	M->REG.CJTO			= (int8_t)BufferIn[10];
-	M->REG.CJT.H		= BufferIn[11];
-	M->REG.CJT.L		= BufferIn[12];
-	M->REG.LTC.H		= BufferIn[13];
-	M->REG.LTC.M		= BufferIn[14];
-	M->REG.LTC.L		= BufferIn[15];
-	M->REG.SR.WORD		= BufferIn[16];
+	M->REG.CJT.H		= BufferIn[1];
+	M->REG.CJT.L		= BufferIn[2];
+	M->REG.LTC.H		= BufferIn[3];
+	M->REG.LTC.M		= BufferIn[4];
+	M->REG.LTC.L		= BufferIn[5];
+	M->REG.SR.WORD		= BufferIn[6];
 }//===============================================================================================
 
 /*
 Set the MAX31856 to the factory default values then writing the structure down to the MAX31856
 */
-void MAX31856SetFactoryDefault(struct MAX31856_REG_Struct * M = &MAX31856) {
+void MAX31856SetFactoryDefault(struct MAX31856_REG_Struct * M = &MAX31856, uint8_t CSPin = MAX31856_NO_PIN) {
 
 	M->REG.CR0.WORD =	0x00;	//CR0
 	M->REG.CR1.WORD =	0x03;	//CR1
@@ -490,5 +871,2306 @@ void MAX31856SetFactoryDefault(struct MAX31856_REG_Struct * M = &MAX31856) {
 	M->REG.LTC.L =		0x00;	//LTCL
 	M->REG.SR.WORD =	0x00;	//SR
 
-	MAX31856WriteRegisters(M);
+	MAX31856WriteRegisters(M, CSPin);
+} //===============================================================================================
+
+/*
+Several MAX31856 on one SPI bus
+Each MAX31856 gets a MAX31856_Device_Struct carrying its own chip select, optional DRDY pin and register image.
+A MAX31856_Bus_Struct then spreads the reads across all of the devices so the bus stays busy and every channel is serviced in turn.
+Typical Use:
+	MAX31856_Device_Struct TC[16];
+	MAX31856_Bus_Struct Bus;
+	void ICACHE_RAM_ATTR TC0DRDY() { MAX31856DRDYInterrupt(&TC[0]); } //Optional, one tiny ISR per device if DRDY is wired to an interrupt
+
+	Setup {
+		SPI.begin();
+		for (uint8_t i = 0; i < 16; i++) {
+			MAX31856Begin(&TC[i], CS_PINS[i], DRDY_PINS[i]);
+			TC[i].M.REG.CR0.CMODE = true;
+			TC[i].M.REG.CR1.AVGSEL = 2;
+			MAX31856WriteRegisters(&TC[i]);
+		}
+		MAX31856BusBegin(&Bus, &TC[0], 16, MAX31856_BUS_DRDY_PRIORITY);
+		Bus.FastRead = true; //Configuration is already known, only pull CJT/LTC/SR
+	}
+
+	Loop() {
+		int8_t i = MAX31856BusService(&Bus); //Reads at most one device, returns its index or -1 if nothing was ready
+		if (i >= 0) {
+			MAX31856Calculate(&TC[i].M);
+			...
+		}
+	}
+*/
+#define MAX31856_WRITE_MERGE_GAP	2	//Unchanged registers bridged inside one burst rather than paying the address byte and CS setup of a second burst
+#define MAX31856_BUS_ROUND_ROBIN	0	//Read every device in turn regardless of DRDY
+#define MAX31856_BUS_DRDY_PRIORITY	1	//Only read devices with DRDY asserted, scanning on from the last device read so no channel is starved
+#define MAX31856_LATENCY_BINS		12	//Bin 0 counts 0us transactions, bin n 2^(n-1) to 2^n-1us, the last bin everything from 1024us up
+struct MAX31856_Instrument_Struct {	//Reads through TconvMaxMicros are sent in stats frames, see MAX31856InstrumentCounters
+	uint32_t Reads;				//Register reads through the device handle
+	uint32_t Writes;			//Register writes, a diff write split into several bursts counts once
+	uint32_t BytesRead;			//Bytes clocked, address byte included
+	uint32_t BytesWritten;
+	uint32_t BusMicros;			//Time spent in reads and writes
+	uint32_t MaxBusMicros;		//Longest single read or write
+	uint32_t Samples;			//Reads that brought in LTC, MAX31856AsyncService() samples included
+	uint32_t Intervals;			//Sample to sample intervals measured
+	uint32_t SumIntervalMicros;
+	uint32_t MinIntervalMicros;
+	uint32_t MaxIntervalMicros;
+	uint32_t Early;				//Continuous mode, samples read sooner than Tconv after the previous one
+	uint32_t Missed;			//Continuous mode, conversions estimated to have come and gone unread
+	uint32_t Stale;				//Samples with CJT, LTC and SR identical to the previous sample
+	uint32_t Faults;			//Samples with any SR bit set
+	uint32_t TconvMicros;		//Typical and maximum conversion time for the configuration of the last sample
+	uint32_t TconvMaxMicros;
+	uint16_t Latency[MAX31856_LATENCY_BINS];	//log2 histogram of read and write times, saturates at 65535
+	uint8_t TconvConfig[2];		//CR0 and CR1 the conversion times were worked out for
+	uint8_t Last[6];			//CJTH through SR of the previous sample
+	uint32_t MarkMicros;		//micros() and MAX31856SPICounters.Bytes when the current transaction started
+	uint32_t MarkBytes;
+};
+struct MAX31856_Device_Struct {
+	struct MAX31856_REG_Struct M;	//Register image of this device
+	uint8_t CSPin;
+	uint8_t DRDYPin;			//MAX31856_NO_PIN if DRDY is not wired to a GPIO
+	volatile bool DataReady;	//Set from a DRDY ISR, cleared when the device is read
+	volatile uint32_t DRDYMicros;	//No later than the next DRDY edge: stamped at the edge by MAX31856DRDYInterrupt(), or when DRDY was last seen inactive
+	uint32_t EdgeMicros;		//DRDY edge of the conversion the last read took, 0 if not known (no DRDY, or it was read before DRDY)
+	uint32_t LastReadMicros;	//micros() at the last register read, 0 if never read
+	uint8_t Shadow[12];			//Registers 0x00-0x0B as last written to this device
+	bool ShadowValid;			//False until the first full write, clear it to force the next write to be a full burst
+#ifdef MAX31856_INSTRUMENTATION
+	struct MAX31856_Instrument_Struct I;	//Bus and sample health counters, see MAX31856PrintInstruments()
+#endif
+};
+struct MAX31856_ExternalCJ_Struct;
+struct MAX31856_Bus_Struct {
+	struct MAX31856_Device_Struct * Devices;
+	uint8_t NumDevices;
+	uint8_t Mode;				//MAX31856_BUS_ROUND_ROBIN or MAX31856_BUS_DRDY_PRIORITY
+	uint8_t Next;				//Index of the next device to consider
+	uint32_t Reads;				//Device reads since MAX31856BusBegin()
+	uint32_t StartMicros;		//micros() at MAX31856BusBegin(), used for the channel rate
+	uint32_t MaxIntervalMicros;	//Longest any single device has waited between two reads
+	bool FastRead;				//Read only CJT/LTC/SR (7 bytes) instead of the whole register file (17 bytes)
+	struct MAX31856_ExternalCJ_Struct * ExternalCJ;	//Optional, pushed to each device right after its read, see MAX31856ExternalCJService()
+};
+
+/*
+Instrumentation hooks around every read and write made through a device handle.  They are off by default and cost nothing,
+define MAX31856_INSTRUMENTATION before including this file to add the counters to MAX31856_Device_Struct (about 100 bytes
+of RAM per device) and a few micros() calls to every transfer
+*/
+#ifdef MAX31856_INSTRUMENTATION
+void MAX31856InstrumentBegin(struct MAX31856_Device_Struct * D) {
+	noInterrupts();
+	D->I.MarkBytes = MAX31856SPICounters.Bytes;
+	interrupts();
+	D->I.MarkMicros = micros();
+} //===============================================================================================
+uint32_t MAX31856InstrumentEnd(struct MAX31856_Device_Struct * D, bool Write) {
+	uint32_t Now = micros();
+	struct MAX31856_Instrument_Struct * I = &D->I;
+	noInterrupts();
+	uint32_t Bytes = MAX31856SPICounters.Bytes - I->MarkBytes;
+	interrupts();
+	uint32_t Micros = Now - I->MarkMicros;
+	if (Write) {
+		I->Writes++;
+		I->BytesWritten += Bytes;
+	}
+	else {
+		I->Reads++;
+		I->BytesRead += Bytes;
+	}
+	I->BusMicros += Micros;
+	if (Micros > I->MaxBusMicros) I->MaxBusMicros = Micros;
+	uint8_t Bin = 0;
+	for (uint32_t v = Micros; v && Bin < MAX31856_LATENCY_BINS - 1; v >>= 1) Bin++;
+	if (I->Latency[Bin] != 0xFFFF) I->Latency[Bin]++;
+	return Now;
+} //===============================================================================================
+
+/*
+A new sample has been read at Now, before D->LastReadMicros moves on
+*/
+void MAX31856InstrumentSample(struct MAX31856_Device_Struct * D, uint32_t Now) {
+	struct MAX31856_Instrument_Struct * I = &D->I;
+	struct MAX31856_REG_Struct * M = &D->M;
+	if (I->TconvConfig[0] != M->REG.CR0.WORD || I->TconvConfig[1] != M->REG.CR1.WORD || I->TconvMicros == 0) {
+		float Tconv, TconvMax;
+		MAX31856ConversionTime(&Tconv, &TconvMax, M);
+		I->TconvMicros = uint32_t(Tconv * 1000.0);
+		I->TconvMaxMicros = uint32_t(TconvMax * 1000.0);
+		I->TconvConfig[0] = M->REG.CR0.WORD;
+		I->TconvConfig[1] = M->REG.CR1.WORD;
+	}
+
+	if (I->Samples != 0) {
+		uint32_t Interval = Now - D->LastReadMicros;
+		I->Intervals++;
+		I->SumIntervalMicros += Interval;
+		if (Interval < I->MinIntervalMicros || I->Intervals == 1) I->MinIntervalMicros = Interval;
+		if (Interval > I->MaxIntervalMicros) I->MaxIntervalMicros = Interval;
+		if (M->REG.CR0.CMODE) {
+			if (Interval < I->TconvMicros) I->Early++;
+			else if (I->TconvMaxMicros != 0 && Interval >= 2 * I->TconvMaxMicros) I->Missed += Interval / I->TconvMaxMicros - 1;
+		}
+	}
+
+	uint8_t Sample[6] = { M->REG.CJT.H, M->REG.CJT.L, M->REG.LTC.H, M->REG.LTC.M, M->REG.LTC.L, M->REG.SR.WORD };
+	if (I->Samples != 0 && memcmp(&Sample[0], &I->Last[0], sizeof(Sample)) == 0) I->Stale++;
+	memcpy(&I->Last[0], &Sample[0], sizeof(Sample));
+	if (Sample[5]) I->Faults++;
+	I->Samples++;
+} //===============================================================================================
+
+void MAX31856InstrumentReset(struct MAX31856_Device_Struct * D) {
+	memset((void *)&D->I, 0, sizeof(struct MAX31856_Instrument_Struct));
+} //===============================================================================================
+#else
+inline void MAX31856InstrumentBegin(struct MAX31856_Device_Struct *) {}
+inline uint32_t MAX31856InstrumentEnd(struct MAX31856_Device_Struct *, bool) { return micros(); }
+inline void MAX31856InstrumentSample(struct MAX31856_Device_Struct *, uint32_t) {}
+inline void MAX31856InstrumentReset(struct MAX31856_Device_Struct *) {}
+#endif
+
+/*
+Print a devices instrumentation counters, or append them to a String.  The counters wrap, for rates take the difference
+between two dumps.  BusMicros against the time between the dumps is how busy the bus is with this device
+Typical Use (with MAX31856_INSTRUMENTATION defined):
+	MAX31856PrintInstruments(Serial, &TC[3].I);
+	OR
+	String s;
+	MAX31856GetInstrumentsString(s, &TC[3].I);
+	Serial.print(s);
+*/
+void MAX31856PrintInstruments(Print &p, struct MAX31856_Instrument_Struct * I) {
+	p.print(F("Reads: ")); p.print((unsigned long)I->Reads); p.print(F(" (")); p.print((unsigned long)I->BytesRead); p.print(F(" bytes)\r\n"));
+	p.print(F("Writes: ")); p.print((unsigned long)I->Writes); p.print(F(" (")); p.print((unsigned long)I->BytesWritten); p.print(F(" bytes)\r\n"));
+	p.print(F("Bus Time: ")); p.print((unsigned long)I->BusMicros); p.print(F("us total, ")); p.print((unsigned long)I->MaxBusMicros); p.print(F("us max\r\n"));
+	p.print(F("Samples: ")); p.print((unsigned long)I->Samples);
+	p.print(F(", Stale: ")); p.print((unsigned long)I->Stale);
+	p.print(F(", Faults: ")); p.print((unsigned long)I->Faults); p.print(F("\r\n"));
+	p.print(F("Sample Interval: "));
+	if (I->Intervals) {
+		p.print((unsigned long)I->MinIntervalMicros); p.print(F("us min, "));
+		p.print((unsigned long)(I->SumIntervalMicros / I->Intervals)); p.print(F("us mean, "));
+		p.print((unsigned long)I->MaxIntervalMicros); p.print(F("us max"));
+	}
+	else {
+		p.print(F("N/A"));
+	}
+	p.print(F(" vs Tconv ")); p.print((unsigned long)I->TconvMicros); p.print(F("us typical, ")); p.print((unsigned long)I->TconvMaxMicros); p.print(F("us max\r\n"));
+	p.print(F("Early: ")); p.print((unsigned long)I->Early); p.print(F(", Missed: ")); p.print((unsigned long)I->Missed); p.print(F("\r\n"));
+	p.print(F("Latency:"));
+	for (uint8_t i = 0; i < MAX31856_LATENCY_BINS; i++) {
+		if (!I->Latency[i]) continue;
+		p.print(F("	>="));
+		p.print(i ? (1UL << (i - 1)) : 0UL);
+		p.print(F("us: "));
+		p.print(I->Latency[i]);
+	}
+	p.print(F("\r\n"));
+} //===============================================================================================
+void MAX31856GetInstrumentsString(String &s, struct MAX31856_Instrument_Struct * I) {
+	MAX31856StringPrint p(s);
+	MAX31856PrintInstruments(p, I);
+} //===============================================================================================
+
+/*
+Set up a device handle and its pins.  The register image is cleared, so fill in D->M.REG before MAX31856WriteRegisters(D)
+Typical Use:
+	MAX31856Begin(&TC[0], 15);		//CS on GPIO15, no DRDY
+	MAX31856Begin(&TC[1], 16, 5);	//CS on GPIO16, DRDY on GPIO5
+*/
+void MAX31856Begin(struct MAX31856_Device_Struct * D, uint8_t CSPin, uint8_t DRDYPin = MAX31856_NO_PIN) {
+	memset((void *)D, 0, sizeof(struct MAX31856_Device_Struct));
+	D->CSPin = CSPin;
+	D->DRDYPin = DRDYPin;
+	if (CSPin != MAX31856_NO_PIN) {
+		pinMode(CSPin, OUTPUT);
+		digitalWrite(CSPin, HIGH);
+	}
+	if (DRDYPin != MAX31856_NO_PIN) pinMode(DRDYPin, INPUT);
+} //===============================================================================================
+
+/*
+True if the device has a conversion waiting, either flagged by a DRDY ISR or read straight off the DRDY pin (active low)
+*/
+bool MAX31856DataReady(struct MAX31856_Device_Struct * D) {
+	if (D->DataReady) return true;
+	uint32_t Now = micros(); //Taken before the pin is read, so a DRDY edge in between is never stamped early
+	if (D->DRDYPin != MAX31856_NO_PIN && digitalRead(D->DRDYPin) == LOW) return true;
+	D->DRDYMicros = Now ? Now : 1; //Not ready yet, so the next edge is still to come
+	return false;
+} //===============================================================================================
+
+/*
+Body for a DRDY ISR.  Flags the conversion and stamps its edge, which tells MAX31856ExternalCJService() how far into the next
+conversion a write would land
+Typical Use:
+	void ICACHE_RAM_ATTR TC0DRDY() { MAX31856DRDYInterrupt(&TC[0]); }
+	attachInterrupt(digitalPinToInterrupt(5), TC0DRDY, FALLING);
+*/
+void MAX31856_ISR_ATTR MAX31856DRDYInterrupt(struct MAX31856_Device_Struct * D) {
+	uint32_t Now = micros();
+	D->DRDYMicros = Now ? Now : 1;
+	D->DataReady = true;
+} //===============================================================================================
+
+/*
+Start of a read through a device handle.  Notes the DRDY edge of the conversion about to be read, 0 if nothing says it is a new
+one, and clears DataReady first so a DRDY arriving during the read is not lost
+*/
+void MAX31856ReadStart(struct MAX31856_Device_Struct * D) {
+	uint32_t Now = micros();
+	D->EdgeMicros = MAX31856DataReady(D) ? D->DRDYMicros : 0;
+	D->DataReady = false;
+	D->DRDYMicros = Now ? Now : 1; //Any later DRDY belongs to the next conversion
+} //===============================================================================================
+
+/*
+Device handle versions of MAX31856ReadRegisters()/MAX31856WriteRegisters() using the devices own chip select and register image.
+The write only sends the registers that differ from the last image written to the device, merging bursts separated by
+MAX31856_WRITE_MERGE_GAP or fewer unchanged registers.  The first write, or any write with ForceFull, sends all 12 registers.
+CR0 is always resent while ONESHOT or FAULTCLR is set since those are commands rather than configuration.  CJTH/CJTL are
+left out while the internal cold junction sensor is on (CR0.CJ = 0), a read puts the live reading there.
+Typical Use:
+	MAX31856ReadRegisters(&TC[3]);
+	MAX31856Calculate(&TC[3].M);
+
+	TC[3].M.REG.CR1.AVGSEL = 1;
+	MAX31856WriteRegisters(&TC[3]);			//2 bytes: address + CR1
+	MAX31856WriteRegisters(&TC[3], true);	//All 13 bytes, e.g. after a brown-out reset the chip
+*/
+void MAX31856ReadRegisters(struct MAX31856_Device_Struct * D) {
+	MAX31856ReadStart(D);
+	MAX31856InstrumentBegin(D);
+	MAX31856ReadRegisters(&D->M, D->CSPin);
+	uint32_t Now = MAX31856InstrumentEnd(D, false);
+	MAX31856InstrumentSample(D, Now);
+	D->LastReadMicros = Now;
+} //===============================================================================================
+void MAX31856WriteRegisters(struct MAX31856_Device_Struct * D, bool ForceFull = false) {
+	uint8_t Image[12];
+	MAX31856PackConfig(&D->M, &Image[0]);
+	uint16_t Dirty = 0x0FFF; //Full write, merges into a single burst
+	if (!ForceFull && D->ShadowValid) {
+		Dirty = 0;
+		for (uint8_t i = 0; i < sizeof(Image); i++) {
+			if (Image[i] != D->Shadow[i]) Dirty |= (1 << i);
+		}
+		if (D->M.REG.CR0.ONESHOT || D->M.REG.CR0.FAULTCLR) Dirty |= 1;
+		if (!D->M.REG.CR0.CJ) Dirty &= ~0x0C00;				//CJTH/CJTL hold the internal sensor reading, not something to write back
+		else if (!(D->Shadow[0] & 0x08)) Dirty |= 0x0C00;	//Internal sensor just switched off, the shadow only holds its last reading
+	}
+
+	if (Dirty) {
+		MAX31856InstrumentBegin(D);
+		uint8_t i = 0;
+		while (i < sizeof(Image)) {
+			if (!(Dirty & (1 << i))) { i++; continue; }
+			uint8_t End = i; //Last dirty register in this burst
+			for (uint8_t j = i + 1; j < sizeof(Image) && j - End - 1 <= MAX31856_WRITE_MERGE_GAP; j++) {
+				if (Dirty & (1 << j)) End = j;
+			}
+			MAX31856WriteRange(D->CSPin, i, &Image[i], End - i + 1);
+			i = End + 1;
+		}
+		MAX31856InstrumentEnd(D, true);
+	}
+	memcpy(&D->Shadow[0], &Image[0], sizeof(Image));
+	D->ShadowValid = true;
+} //===============================================================================================
+void MAX31856ReadTemperature(struct MAX31856_Device_Struct * D) {
+	MAX31856ReadStart(D);
+	MAX31856InstrumentBegin(D);
+	MAX31856ReadTemperature(&D->M, D->CSPin);
+	uint32_t Now = MAX31856InstrumentEnd(D, false);
+	MAX31856InstrumentSample(D, Now);
+	D->LastReadMicros = Now;
+} //===============================================================================================
+void MAX31856ReadCJAndTemperature(struct MAX31856_Device_Struct * D) {
+	MAX31856ReadStart(D);
+	MAX31856InstrumentBegin(D);
+	MAX31856ReadCJAndTemperature(&D->M, D->CSPin);
+	uint32_t Now = MAX31856InstrumentEnd(D, false);
+	MAX31856InstrumentSample(D, Now);
+	D->LastReadMicros = Now;
+} //===============================================================================================
+
+/*
+Set up a bus scheduler over an array of devices that have already been through MAX31856Begin()
+*/
+void MAX31856BusBegin(struct MAX31856_Bus_Struct * B, struct MAX31856_Device_Struct * Devices, uint8_t NumDevices, uint8_t Mode = MAX31856_BUS_ROUND_ROBIN) {
+	B->Devices = Devices;
+	B->NumDevices = NumDevices;
+	B->Mode = Mode;
+	B->Next = 0;
+	B->Reads = 0;
+	B->StartMicros = micros();
+	B->MaxIntervalMicros = 0;
+	B->FastRead = false;
+	B->ExternalCJ = NULL;
+} //===============================================================================================
+
+/*
+Read the next device that is due.  Call this as often as possible from the main loop, each call is at most one SPI transaction.
+In round robin mode every call reads a device, so each channel is read once every NumDevices calls.
+In DRDY priority mode only devices with a fresh conversion are read, the scan starts after the last device read so every
+ready channel is reached within NumDevices calls.  A main loop slower than the conversions should use MAX31856BusServiceAll().
+If B->ExternalCJ is set the device gets the external cold junction temperature straight after its read when it needs it.
+Returns the index of the device that was read, or -1 if nothing was ready
+*/
+bool MAX31856ExternalCJService(struct MAX31856_ExternalCJ_Struct * X, struct MAX31856_Device_Struct * D);
+int8_t MAX31856BusService(struct MAX31856_Bus_Struct * B) {
+	for (uint8_t n = 0; n < B->NumDevices; n++) {
+		uint8_t i = B->Next;
+		B->Next++;
+		if (B->Next >= B->NumDevices) B->Next = 0;
+		struct MAX31856_Device_Struct * D = &B->Devices[i];
+		if (B->Mode == MAX31856_BUS_DRDY_PRIORITY && !MAX31856DataReady(D)) continue;
+
+		if (D->LastReadMicros != 0) {
+			uint32_t Interval = micros() - D->LastReadMicros;
+			if (Interval > B->MaxIntervalMicros) B->MaxIntervalMicros = Interval;
+		}
+		if (B->FastRead) MAX31856ReadCJAndTemperature(D);
+		else MAX31856ReadRegisters(D);
+		if (B->ExternalCJ != NULL) MAX31856ExternalCJService(B->ExternalCJ, D);
+		B->Reads++;
+		return i;
+	}
+	return -1;
+} //===============================================================================================
+
+/*
+MAX31856BusService() until nothing is ready or Budget devices have been read, so one pass of a slow main loop reads every
+channel with a conversion waiting instead of just one and the channel rate is set by the bus rather than the loop.
+In round robin mode every call reads, so the default Budget of 0 reads each device once.
+Returns the number of devices read
+Typical Use:
+	MAX31856BusServiceAll(&Bus);		//Everything that is ready
+	MAX31856BusServiceAll(&Bus, 4);		//At most 4 reads this pass, the rest wait for the next
+*/
+uint8_t MAX31856BusServiceAll(struct MAX31856_Bus_Struct * B, uint8_t Budget = 0) {
+	if (Budget == 0) Budget = B->NumDevices;
+	uint8_t Reads = 0;
+	while (Reads < Budget && MAX31856BusService(B) >= 0) Reads++;
+	return Reads;
+} //===============================================================================================
+
+/*
+Send the same write to every device on the bus in one transaction by pulling all of the chip selects low together.
+Only for writes, the MISO lines would fight on a read.  Every device must have a CSPin
+*/
+void MAX31856BusBroadcast(struct MAX31856_Bus_Struct * B, const uint8_t * BufferOut, uint16_t Length) {
+	MAX31856BusClaim();
+	MAX31856Transport->Begin();
+	for (uint8_t i = 0; i < B->NumDevices; i++) MAX31856Transport->Select(B->Devices[i].CSPin, true);
+	MAX31856Transport->Transfer(BufferOut, NULL, Length);
+	for (uint8_t i = 0; i < B->NumDevices; i++) MAX31856Transport->Select(B->Devices[i].CSPin, false);
+	MAX31856Transport->End();
+	MAX31856BusRelease(Length);
+} //===============================================================================================
+
+/*
+Start a one shot conversion on every device.
+If all of the devices share the same CR0 the ONESHOT is broadcast so every conversion starts on the same SCLK edge,
+otherwise each device gets its own 2 byte CR0 write back to back.
+Typical Use:
+	MAX31856BusOneShot(&Bus);
+	//...wait for DRDY or Tconv then MAX31856BusService(&Bus) until every device has been read
+*/
+void MAX31856BusOneShot(struct MAX31856_Bus_Struct * B) {
+	if (B->NumDevices == 0) return;
+	bool Broadcast = true;
+	for (uint8_t i = 0; i < B->NumDevices; i++) {
+		if (B->Devices[i].CSPin == MAX31856_NO_PIN || B->Devices[i].M.REG.CR0.WORD != B->Devices[0].M.REG.CR0.WORD) Broadcast = false;
+	}
+
+	uint8_t BufferOut[2];
+	BufferOut[0] = 0x80; //CR0 write address
+	if (Broadcast) {
+		BufferOut[1] = (B->Devices[0].M.REG.CR0.WORD | 0x40) & ~0x02; //Set ONESHOT, never send FAULTCLR along with it
+		MAX31856BusBroadcast(B, &BufferOut[0], sizeof(BufferOut));
+	}
+	else {
+		for (uint8_t i = 0; i < B->NumDevices; i++) {
+			BufferOut[1] = (B->Devices[i].M.REG.CR0.WORD | 0x40) & ~0x02;
+			MAX31856Transfer(B->Devices[i].CSPin, &BufferOut[0], NULL, sizeof(BufferOut));
+		}
+	}
+} //===============================================================================================
+
+/*
+Channels read per second since MAX31856BusBegin().  Compare against device count to see when the bus saturates, see
+extras/host/MAX31856BusBench.cpp for a sweep against the simulator
+Typical Use:
+	Serial.print(MAX31856BusChannelsPerSecond(&Bus)); Serial.print(F(" ch/s, worst channel gap ")); Serial.println(Bus.MaxIntervalMicros);
+*/
+float MAX31856BusChannelsPerSecond(struct MAX31856_Bus_Struct * B) {
+	uint32_t Elapsed = micros() - B->StartMicros;
+	if (Elapsed == 0) return 0.0;
+	return float(B->Reads) * 1000000.0 / float(Elapsed);
+} //===============================================================================================
+
+/*
+Binary telemetry frames for logging every sample over a slow UART or radio link.
+All multi-byte fields are little endian, the CRC is CRC-16/CCITT-FALSE over every byte before it.
+	Byte 0		MAX31856_FRAME_SYNC
+	Byte 1		MAX31856_FRAME_VERSION
+	Byte 2		Frame type
+	Byte 3		Device ID
+	Byte 4-5	Sequence number, +1 per frame so the receiver can count lost frames
+	Byte 6-9	Timestamp, whatever the sender passes in (millis(), micros(), ...)
+	Payload		MAX31856_FRAME_FULL:  all 16 registers 0x00-0x0F (28 byte frame)
+				MAX31856_FRAME_DELTA: registers 0x0A-0x0F, CJTH CJTL LTCBH LTCBM LTCBL SR (18 byte frame)
+				MAX31856_FRAME_STATS: MAX31856_Instrument_Struct, the uint32_t counters Reads through TconvMaxMicros then
+				                      the Latency bins (104 byte frame, see MAX31856EncodeStatsFrame())
+	Last 2		CRC
+A delta frame is sent while registers 0x00-0x09 are unchanged since the last full frame.  A full frame is also forced every
+FullEvery frames so a receiver that starts late or drops a frame picks the configuration back up.
+Typical Use:
+	MAX31856_Telemetry_Struct T;
+	MAX31856TelemetryBegin(&T, 3);	//Device ID 3
+	Loop() {
+		MAX31856ReadTemperature();
+		uint8_t Frame[MAX31856_FRAME_MAX_LEN];
+		uint8_t Length = MAX31856EncodeFrame(&T, &Frame[0], millis());
+		Serial.write(Frame, Length);
+	}
+
+	Host side:
+	MAX31856_FrameDecoder_Struct R[256] = {};	//One per device ID
+	if (MAX31856DecodeFrame(&R[Frame[3]], Frame, Length) >= 0) printf("%f\n", R[Frame[3]].M.LTCT);
+*/
+#define MAX31856_FRAME_SYNC			0xA5
+#define MAX31856_FRAME_VERSION		1
+#define MAX31856_FRAME_FULL			0
+#define MAX31856_FRAME_DELTA		1
+#define MAX31856_FRAME_STATS		2
+#define MAX31856_FRAME_HEADER_LEN	10
+#define MAX31856_FRAME_MAX_LEN		(MAX31856_FRAME_HEADER_LEN + 16 + 2)	//Register frames, stats frames are longer
+#define MAX31856_INSTRUMENT_COUNTERS	17	//Entries in MAX31856InstrumentCounters
+#define MAX31856_FRAME_STATS_LEN	(MAX31856_FRAME_HEADER_LEN + MAX31856_INSTRUMENT_COUNTERS * 4 + MAX31856_LATENCY_BINS * 2 + 2)
+#define MAX31856_FRAME_ERR_SHORT	-1	//Fewer bytes than the frame type needs
+#define MAX31856_FRAME_ERR_FORMAT	-2	//Bad sync, version or type
+#define MAX31856_FRAME_ERR_CRC		-3
+#define MAX31856_FRAME_ERR_NO_CONFIG	-4	//Delta frame before any full frame from this device
+#define MAX31856_FRAME_ERR_STALE	-5	//Duplicate, or older than the last good frame (reordered by the link)
+#define MAX31856_FRAME_RESYNC		32	//A sequence number this far behind the last good one is a restarted sender, not a late frame
+struct MAX31856_Telemetry_Struct {
+	uint8_t DeviceID;
+	uint16_t Sequence;		//Sequence number of the next frame
+	uint8_t FullEvery;		//Force a full frame at least this often, 0 to only send them on a configuration change
+	uint8_t SinceFull;		//Frames since the last full frame
+	bool ConfigValid;		//False until the first full frame
+	uint8_t Config[10];		//Registers 0x00-0x09 as sent in the last full frame
+};
+struct MAX31856_FrameDecoder_Struct {
+	struct MAX31856_REG_Struct M;	//Rebuilt register image, doubles already calculated
+	uint8_t Registers[16];			//Raw registers 0x00-0x0F
+	bool ConfigValid;				//A full frame has been received
+	uint8_t DeviceID;
+	uint16_t Sequence;				//Sequence number of the last good frame
+	uint32_t Timestamp;				//Timestamp of the last good frame
+	uint32_t Frames;				//Good frames received
+	uint32_t Lost;					//Frames missing from gaps in the sequence numbers
+	uint32_t Stale;					//Duplicate or reordered frames dropped
+	struct MAX31856_Instrument_Struct I;	//Counters from the last stats frame
+};
+
+/*
+CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), pass the previous result back in as CRC to continue over several buffers
+*/
+uint16_t MAX31856CRC16(const uint8_t * Data, uint16_t Length, uint16_t CRC = 0xFFFF) {
+	while (Length--) {
+		CRC ^= uint16_t(*Data++) << 8;
+		for (uint8_t i = 0; i < 8; i++) {
+			CRC = (CRC & 0x8000) ? (CRC << 1) ^ 0x1021 : (CRC << 1);
+		}
+	}
+	return CRC;
+} //===============================================================================================
+
+/*
+Total frame length for a frame type, 0 if the type is unknown.  Handy when pulling frames out of a byte stream
+*/
+uint8_t MAX31856FrameLength(uint8_t Type) {
+	if (Type == MAX31856_FRAME_FULL) return MAX31856_FRAME_HEADER_LEN + 16 + 2;
+	if (Type == MAX31856_FRAME_DELTA) return MAX31856_FRAME_HEADER_LEN + 6 + 2;
+	if (Type == MAX31856_FRAME_STATS) return MAX31856_FRAME_STATS_LEN;
+	return 0;
+} //===============================================================================================
+
+void MAX31856TelemetryBegin(struct MAX31856_Telemetry_Struct * T, uint8_t DeviceID, uint8_t FullEvery = 50) {
+	memset((void *)T, 0, sizeof(struct MAX31856_Telemetry_Struct));
+	T->DeviceID = DeviceID;
+	T->FullEvery = FullEvery;
+} //===============================================================================================
+
+/*
+Shared by every frame type: fill in the header at the start of Frame and the CRC after Length bytes.  Returns the frame length
+*/
+uint8_t MAX31856FrameSeal(struct MAX31856_Telemetry_Struct * T, uint8_t * Frame, uint8_t Type, uint32_t Timestamp, uint8_t Length) {
+	Frame[0] = MAX31856_FRAME_SYNC;
+	Frame[1] = MAX31856_FRAME_VERSION;
+	Frame[2] = Type;
+	Frame[3] = T->DeviceID;
+	Frame[4] = uint8_t(T->Sequence);
+	Frame[5] = uint8_t(T->Sequence >> 8);
+	Frame[6] = uint8_t(Timestamp);
+	Frame[7] = uint8_t(Timestamp >> 8);
+	Frame[8] = uint8_t(Timestamp >> 16);
+	Frame[9] = uint8_t(Timestamp >> 24);
+	uint16_t CRC = MAX31856CRC16(Frame, Length);
+	Frame[Length] = uint8_t(CRC);
+	Frame[Length + 1] = uint8_t(CRC >> 8);
+	T->Sequence++;
+	return Length + 2;
+} //===============================================================================================
+
+/*
+Build the next frame for M into Frame (at least MAX31856_FRAME_MAX_LEN bytes), picking full or delta automatically.
+Returns the number of bytes to send
+*/
+uint8_t MAX31856EncodeFrame(struct MAX31856_Telemetry_Struct * T, uint8_t * Frame, uint32_t Timestamp, struct MAX31856_REG_Struct * M = &MAX31856) {
+	uint8_t * Payload = &Frame[MAX31856_FRAME_HEADER_LEN];
+	MAX31856PackRegisters(M, Payload);
+
+	bool Full = !T->ConfigValid || memcmp(&T->Config[0], Payload, sizeof(T->Config)) != 0;
+	if (T->FullEvery != 0 && T->SinceFull + 1 >= T->FullEvery) Full = true;
+	if (Full) {
+		memcpy(&T->Config[0], Payload, sizeof(T->Config));
+		T->ConfigValid = true;
+		T->SinceFull = 0;
+		return MAX31856FrameSeal(T, Frame, MAX31856_FRAME_FULL, Timestamp, MAX31856_FRAME_HEADER_LEN + 16);
+	}
+	memmove(Payload, &Payload[10], 6); //Keep only CJTH through SR
+	T->SinceFull++;
+	return MAX31856FrameSeal(T, Frame, MAX31856_FRAME_DELTA, Timestamp, MAX31856_FRAME_HEADER_LEN + 6);
+} //===============================================================================================
+
+/*
+The MAX31856_Instrument_Struct counters carried by a stats frame, in frame order.  Append new counters at the end and bump
+MAX31856_FRAME_VERSION
+*/
+uint32_t MAX31856_Instrument_Struct::* const MAX31856InstrumentCounters[] = {
+	&MAX31856_Instrument_Struct::Reads,			&MAX31856_Instrument_Struct::Writes,
+	&MAX31856_Instrument_Struct::BytesRead,		&MAX31856_Instrument_Struct::BytesWritten,
+	&MAX31856_Instrument_Struct::BusMicros,		&MAX31856_Instrument_Struct::MaxBusMicros,
+	&MAX31856_Instrument_Struct::Samples,		&MAX31856_Instrument_Struct::Intervals,
+	&MAX31856_Instrument_Struct::SumIntervalMicros,
+	&MAX31856_Instrument_Struct::MinIntervalMicros,	&MAX31856_Instrument_Struct::MaxIntervalMicros,
+	&MAX31856_Instrument_Struct::Early,			&MAX31856_Instrument_Struct::Missed,
+	&MAX31856_Instrument_Struct::Stale,			&MAX31856_Instrument_Struct::Faults,
+	&MAX31856_Instrument_Struct::TconvMicros,	&MAX31856_Instrument_Struct::TconvMaxMicros,
+};
+static_assert(sizeof(MAX31856InstrumentCounters) / sizeof(MAX31856InstrumentCounters[0]) == MAX31856_INSTRUMENT_COUNTERS,
+	"MAX31856_INSTRUMENT_COUNTERS does not match MAX31856InstrumentCounters");
+
+/*
+Build a stats frame of a devices instrumentation counters into Frame (at least MAX31856_FRAME_STATS_LEN bytes).  It shares
+the sequence numbers of T, so send it down the same link as the register frames.  Returns the number of bytes to send
+Typical Use:
+	uint8_t Frame[MAX31856_FRAME_STATS_LEN];
+	Serial.write(Frame, MAX31856EncodeStatsFrame(&T, &Frame[0], millis(), &TC[3].I));
+*/
+uint8_t MAX31856EncodeStatsFrame(struct MAX31856_Telemetry_Struct * T, uint8_t * Frame, uint32_t Timestamp, struct MAX31856_Instrument_Struct * I) {
+	uint8_t * Payload = &Frame[MAX31856_FRAME_HEADER_LEN];
+	for (uint8_t i = 0; i < MAX31856_INSTRUMENT_COUNTERS; i++) {
+		uint32_t Value = I->*MAX31856InstrumentCounters[i];
+		*Payload++ = uint8_t(Value);
+		*Payload++ = uint8_t(Value >> 8);
+		*Payload++ = uint8_t(Value >> 16);
+		*Payload++ = uint8_t(Value >> 24);
+	}
+	for (uint8_t i = 0; i < MAX31856_LATENCY_BINS; i++) {
+		*Payload++ = uint8_t(I->Latency[i]);
+		*Payload++ = uint8_t(I->Latency[i] >> 8);
+	}
+	return MAX31856FrameSeal(T, Frame, MAX31856_FRAME_STATS, Timestamp, MAX31856_FRAME_STATS_LEN - 2);
+} //===============================================================================================
+
+/*
+Receiver side of MAX31856EncodeFrame().  Keep one decoder per device ID, zeroed before the first frame.
+Checks the frame, rebuilds R->M (including the doubles) or for a stats frame R->I and returns the frame type, or one of the
+MAX31856_FRAME_ERR_* codes in which case R is left as it was (apart from counting a stale frame).
+A frame with the same or an older sequence number than the last good one is dropped as stale rather than counted as a wrap
+of the sequence number, unless it is MAX31856_FRAME_RESYNC or more behind, which is taken as the sender starting over.
+A sender that restarts close to where it left off loses frames until it passes the old sequence number, zero the
+decoder when the sender is known to have restarted
+*/
+int8_t MAX31856DecodeFrame(struct MAX31856_FrameDecoder_Struct * R, const uint8_t * Frame, uint16_t Length) {
+	if (Length < MAX31856_FRAME_HEADER_LEN) return MAX31856_FRAME_ERR_SHORT;
+	if (Frame[0] != MAX31856_FRAME_SYNC || Frame[1] != MAX31856_FRAME_VERSION) return MAX31856_FRAME_ERR_FORMAT;
+	uint8_t Type = Frame[2];
+	uint8_t FrameLength = MAX31856FrameLength(Type);
+	if (FrameLength == 0) return MAX31856_FRAME_ERR_FORMAT;
+	if (Length < FrameLength) return MAX31856_FRAME_ERR_SHORT;
+	uint16_t CRC = uint16_t(Frame[FrameLength - 2]) | (uint16_t(Frame[FrameLength - 1]) << 8);
+	if (MAX31856CRC16(Frame, FrameLength - 2) != CRC) return MAX31856_FRAME_ERR_CRC;
+	uint16_t Sequence = uint16_t(Frame[4]) | (uint16_t(Frame[5]) << 8);
+	int16_t Gap = int16_t(uint16_t(Sequence - R->Sequence)); //Frames on from the last good one, across the wrap
+	if (R->Frames != 0 && Gap <= 0 && Gap > -MAX31856_FRAME_RESYNC) {
+		R->Stale++;
+		return MAX31856_FRAME_ERR_STALE;
+	}
+
+	const uint8_t * Payload = &Frame[MAX31856_FRAME_HEADER_LEN];
+	if (Type == MAX31856_FRAME_FULL) {
+		memcpy(&R->Registers[0], Payload, 16);
+		R->ConfigValid = true;
+	}
+	else if (Type == MAX31856_FRAME_STATS) {
+		for (uint8_t i = 0; i < MAX31856_INSTRUMENT_COUNTERS; i++, Payload += 4) {
+			R->I.*MAX31856InstrumentCounters[i] = uint32_t(Payload[0]) | (uint32_t(Payload[1]) << 8) | (uint32_t(Payload[2]) << 16) | (uint32_t(Payload[3]) << 24);
+		}
+		for (uint8_t i = 0; i < MAX31856_LATENCY_BINS; i++, Payload += 2) {
+			R->I.Latency[i] = uint16_t(Payload[0]) | (uint16_t(Payload[1]) << 8);
+		}
+	}
+	else {
+		if (!R->ConfigValid) return MAX31856_FRAME_ERR_NO_CONFIG;
+		memcpy(&R->Registers[10], Payload, 6);
+	}
+
+	if (R->Frames != 0 && Gap > 0) R->Lost += uint16_t(Gap - 1);
+	R->Frames++;
+	R->DeviceID = Frame[3];
+	R->Sequence = Sequence;
+	R->Timestamp = uint32_t(Frame[6]) | (uint32_t(Frame[7]) << 8) | (uint32_t(Frame[8]) << 16) | (uint32_t(Frame[9]) << 24);
+	if (Type == MAX31856_FRAME_STATS) return Type;
+	MAX31856UnpackRegisters(&R->M, &R->Registers[0]);
+	MAX31856Calculate(&R->M);
+	return Type;
+} //===============================================================================================
+
+/*
+Non-blocking, double buffered reads driven by DRDY.
+The DRDY ISR calls MAX31856AsyncStart(), which starts a 7 byte CJT/LTC/SR read into whichever of the two buffers is free and
+returns.  With a TransferAsync in MAX31856Transport the CPU never waits on the bus, otherwise the read is done right there
+with the blocking Transfer.  The main loop calls MAX31856AsyncService(), which decodes the oldest filled buffer, updates the
+devices register image and hands the sample to the callback, so the next read can fill the other buffer while this one is
+being decoded.
+Only one transfer is on the bus at a time, a device whose DRDY comes in while another transfer is running is queued and
+started from the completion of the current one.  Blocking reads and writes (MAX31856WriteRegisters(), fault clears, CJ
+pushes, ...) can be mixed in from the main loop: they wait in MAX31856BusClaim() for a running async transfer and make DRDYs
+that arrive during them queue until they are done.
+Without a TransferAsync the 7 byte read is clocked inside the DRDY ISR, along with the reads of any devices that queued up
+behind it, about 15us each at 5MHz.  That time is spent in the ISR, so keep the bus fast or supply a TransferAsync when many
+devices share it.
+The ISR clocks the bus, so SPI users outside this file must not be cut into either.  Where the SPI library has usingInterrupt()
+(SPI_HAS_NOTUSINGINTERRUPT, e.g. AVR and SAMD) MAX31856AsyncBegin() registers the DRDY interrupt with it, and every
+SPI.beginTransaction() then masks it.  The ESP8266 and ESP32 cores have no such call: wrap the transfers of other libraries on
+the same bus in MAX31856BusClaim()/MAX31856BusRelease(0), or give them a bus of their own.
+When both buffers are still waiting on the main loop the DRDY is dropped and the conversion left unread, which holds DRDY low
+with no further edge to come.  MAX31856AsyncService() starts that read itself once it frees a buffer, by which time a later
+conversion may have replaced it (the sample is stamped with the dropped edge, see MAX31856ExternalCJService()).
+See extras/host/MAX31856AsyncCheck.cpp for the ISR/main loop handoff against the simulator, with and without a TransferAsync.
+Latency is measured from the DRDY edge (the MAX31856AsyncStart() call) to the end of the transfer and to the decoded value.
+Typical Use:
+	MAX31856_Device_Struct TC;
+	MAX31856_Async_Struct A;
+	void MAX31856_ISR_ATTR TCDRDY() { MAX31856AsyncStart(&A); }
+	void NewSample(struct MAX31856_Async_Struct * A, struct MAX31856_Fixed_Struct * T) { PID.Input = T->LTC; }
+
+	Setup {
+		MAX31856Begin(&TC, CS_PIN, DRDY_PIN);
+		...configure TC with CMODE on...
+		MAX31856AsyncBegin(&A, &TC, NewSample);
+		attachInterrupt(digitalPinToInterrupt(DRDY_PIN), TCDRDY, FALLING);
+	}
+	Loop() {
+		MAX31856AsyncService(&A);
+	}
+*/
+#define MAX31856_ASYNC_FREE	0	//Buffer can be filled
+#define MAX31856_ASYNC_BUSY	1	//Transfer into the buffer is running
+#define MAX31856_ASYNC_FULL	2	//Transfer done, waiting to be decoded
+struct MAX31856_Async_Struct;
+typedef void (*MAX31856_AsyncCallback)(struct MAX31856_Async_Struct * A, struct MAX31856_Fixed_Struct * T);
+struct MAX31856_Async_Struct {
+	struct MAX31856_Device_Struct * D;
+	MAX31856_AsyncCallback Callback;		//Called from MAX31856AsyncService() with each decoded sample, may be NULL
+	struct MAX31856_Async_Struct * NextAsync;	//Every pipeline on the bus, for the pending queue
+	uint8_t BufferOut[7];					//0x0A read command
+	uint8_t BufferIn[2][7];					//Raw CJTH..SR, one per buffer
+	volatile uint8_t State[2];				//MAX31856_ASYNC_*
+	volatile uint32_t DRDYMicros[2];		//micros() at the DRDY edge that started each buffer
+	volatile uint32_t DoneMicros[2];		//micros() when each transfer completed
+	volatile uint8_t NextFill;				//Buffer the next transfer goes into
+	uint8_t NextDecode;						//Oldest buffer still to decode
+	volatile bool Pending;					//DRDY seen while the bus was busy
+	volatile uint32_t PendingMicros;		//micros() at that DRDY edge
+	volatile uint32_t Dropped;				//DRDY edges that found both buffers still in use
+	volatile bool Stalled;					//A dropped DRDY left its conversion unread, DRDY is held low until it is
+	volatile uint32_t StalledMicros;		//micros() at that DRDY edge
+	struct MAX31856_Fixed_Struct T;			//Last decoded sample
+	uint32_t Samples;						//Samples decoded
+	uint32_t TransferLatencyMicros;			//DRDY to data in, last sample
+	uint32_t MaxTransferLatencyMicros;
+	uint32_t LatencyMicros;					//DRDY to decoded value, last sample
+	uint32_t MaxLatencyMicros;
+	float AvgLatencyMicros;					//Running average of LatencyMicros
+};
+struct MAX31856_Async_Struct * MAX31856AsyncList = NULL;			//Every pipeline set up with MAX31856AsyncBegin()
+
+void MAX31856AsyncBegin(struct MAX31856_Async_Struct * A, struct MAX31856_Device_Struct * D, MAX31856_AsyncCallback Callback = NULL) {
+	memset((void *)A, 0, sizeof(struct MAX31856_Async_Struct));
+	A->D = D;
+	A->Callback = Callback;
+	A->BufferOut[0] = 0x0A; //Start at CJTH
+	A->NextAsync = MAX31856AsyncList;
+	MAX31856AsyncList = A;
+#if !defined(MAX31856_HOST) && defined(SPI_HAS_NOTUSINGINTERRUPT)
+	if (D->DRDYPin != MAX31856_NO_PIN) SPI.usingInterrupt(digitalPinToInterrupt(D->DRDYPin));
+#endif
+} //===============================================================================================
+
+/*
+End of a transfer, hands the bus back
+*/
+void MAX31856_ISR_ATTR MAX31856AsyncFinish(struct MAX31856_Async_Struct * A) {
+	uint8_t i = A->NextFill ^ 1; //NextFill was moved on when this transfer started
+	if (A->D->CSPin != MAX31856_NO_PIN) MAX31856Transport->Select(A->D->CSPin, false);
+	MAX31856Transport->End();
+	MAX31856SPICounters.Transactions++;
+	MAX31856SPICounters.Bytes += sizeof(A->BufferOut);
+	A->DoneMicros[i] = micros();
+	A->State[i] = MAX31856_ASYNC_FULL;
+	MAX31856AsyncActive = NULL;
+} //===============================================================================================
+
+/*
+Completion callback for the TransferAsync driver (possibly called from its ISR)
+*/
+void MAX31856_ISR_ATTR MAX31856AsyncTransferDone(void * Context) {
+	MAX31856AsyncFinish((struct MAX31856_Async_Struct *)Context);
+	MAX31856AsyncKickPending();
+} //===============================================================================================
+
+/*
+Put a transfer for A on the bus now, the bus must be free.  Returns false if A had nowhere to put it and the DRDY was dropped
+*/
+bool MAX31856_ISR_ATTR MAX31856AsyncKick(struct MAX31856_Async_Struct * A, uint32_t DRDYMicros) {
+	uint8_t i = A->NextFill;
+	if (A->State[i] != MAX31856_ASYNC_FREE) { //Both buffers still waiting on the main loop
+		A->Dropped++;
+		if (!A->Stalled) A->StalledMicros = DRDYMicros;
+		A->Stalled = true;
+		return false;
+	}
+	A->State[i] = MAX31856_ASYNC_BUSY;
+	A->DRDYMicros[i] = DRDYMicros;
+	A->NextFill = i ^ 1;
+	A->D->DataReady = false;
+	MAX31856AsyncActive = A;
+
+	MAX31856Transport->Begin();
+	if (A->D->CSPin != MAX31856_NO_PIN) MAX31856Transport->Select(A->D->CSPin, true);
+	if (MAX31856Transport->TransferAsync) {
+		MAX31856Transport->TransferAsync(&A->BufferOut[0], &A->BufferIn[i][0], sizeof(A->BufferOut), MAX31856AsyncTransferDone, A);
+	}
+	else {
+		MAX31856Transport->Transfer(&A->BufferOut[0], &A->BufferIn[i][0], sizeof(A->BufferOut));
+		MAX31856AsyncFinish(A);
+	}
+	return true;
+} //===============================================================================================
+
+/*
+Start queued devices while the bus is free.  A device that cannot take another sample is dropped and the scan carries on,
+so one slow consumer never leaves the others waiting.  With a blocking Transfer the bus is free again straight away and the
+loop works through every queued device without recursing
+*/
+void MAX31856_ISR_ATTR MAX31856AsyncKickPending() {
+	struct MAX31856_Async_Struct * P = MAX31856AsyncList;
+	while (P != NULL && MAX31856AsyncActive == NULL && !MAX31856BusBlocking) {
+		if (!P->Pending) {
+			P = P->NextAsync;
+			continue;
+		}
+		P->Pending = false;
+		MAX31856AsyncKick(P, P->PendingMicros);
+		P = MAX31856AsyncList; //Earlier devices may have queued during that transfer
+	}
+} //===============================================================================================
+
+/*
+Start a read of A's device into a free buffer.  Meant to be called from the DRDY ISR
+*/
+void MAX31856_ISR_ATTR MAX31856AsyncStart(struct MAX31856_Async_Struct * A) {
+	uint32_t Now = micros();
+	if (MAX31856AsyncActive != NULL || MAX31856BusBlocking) {
+		A->Pending = true;
+		A->PendingMicros = Now;
+		return;
+	}
+	MAX31856AsyncKick(A, Now);
+} //===============================================================================================
+
+/*
+Decode the oldest filled buffer, if there is one, into A->T and the devices register image then call the callback.
+Returns true if a sample was decoded
+*/
+bool MAX31856AsyncService(struct MAX31856_Async_Struct * A) {
+	uint8_t i = A->NextDecode;
+	if (A->State[i] != MAX31856_ASYNC_FULL) return false;
+
+	struct MAX31856_Device_Struct * D = A->D;
+	const uint8_t * In = &A->BufferIn[i][0];
+	D->M.REG.CJT.H = In[1];
+	D->M.REG.CJT.L = In[2];
+	D->M.REG.LTC.H = In[3];
+	D->M.REG.LTC.M = In[4];
+	D->M.REG.LTC.L = In[5];
+	D->M.REG.SR.WORD = In[6];
+	MAX31856InstrumentSample(D, A->DoneMicros[i]);
+	D->LastReadMicros = A->DoneMicros[i];
+	D->EdgeMicros = A->DRDYMicros[i] ? A->DRDYMicros[i] : 1;
+	MAX31856CalculateFixed(&A->T, &D->M);
+
+	uint32_t DRDYMicros = A->DRDYMicros[i];
+	A->TransferLatencyMicros = A->DoneMicros[i] - DRDYMicros;
+	A->State[i] = MAX31856_ASYNC_FREE; //The raw bytes are no longer needed, let the ISR have the buffer back
+	A->NextDecode = i ^ 1;
+	if (A->Stalled) {
+		if (D->DRDYPin == MAX31856_NO_PIN || digitalRead(D->DRDYPin) == LOW) { //No edge will come for it, queue it here
+			noInterrupts();
+			A->Stalled = false;
+			A->Pending = true;
+			A->PendingMicros = A->StalledMicros;
+			MAX31856AsyncKickPending();
+			interrupts();
+		}
+		else A->Stalled = false; //Read by a blocking access meanwhile
+	}
+
+	if (A->Callback) A->Callback(A, &A->T);
+	A->LatencyMicros = micros() - DRDYMicros;
+	if (A->TransferLatencyMicros > A->MaxTransferLatencyMicros) A->MaxTransferLatencyMicros = A->TransferLatencyMicros;
+	if (A->LatencyMicros > A->MaxLatencyMicros) A->MaxLatencyMicros = A->LatencyMicros;
+	A->Samples++;
+	A->AvgLatencyMicros += (float(A->LatencyMicros) - A->AvgLatencyMicros) / float(A->Samples);
+	return true;
+} //===============================================================================================
+
+/*
+Lock-free single producer / single consumer ring of decoded samples, so a slow loop iteration no longer loses data.
+The producer (typically the async callback or the DRDY side) only moves Head and the consumer (the main loop) only moves Tail,
+so neither needs interrupts disabled.  When the ring is full the new sample is dropped and Overruns counts it.
+MAX31856_RING_SIZE must be a power of 2, no more than 128.
+See extras/host/MAX31856RingCheck.cpp for the ring and the statistics below against reference implementations.
+Typical Use:
+	MAX31856_Ring_Struct Ring;		//Zeroed as a global
+	MAX31856_Stats_Struct Stats;
+
+	void NewSample(struct MAX31856_Async_Struct * A, struct MAX31856_Fixed_Struct * T) { MAX31856RingPush(&Ring, T, 0, A->D->LastReadMicros); }
+
+	Setup {
+		MAX31856StatsReset(&Stats);
+	}
+	Loop() {
+		MAX31856_Sample_Struct S;
+		while (MAX31856RingPop(&Ring, &S)) MAX31856StatsAdd(&Stats, &S);
+		PID.Input = MAX31856StatsWindowAverage(&Stats);
+		Slope = MAX31856StatsWindowRate(&Stats);
+	}
+*/
+#ifndef MAX31856_RING_SIZE
+#define MAX31856_RING_SIZE	16
+#endif
+static_assert(MAX31856_RING_SIZE > 0 && MAX31856_RING_SIZE <= 128 && (MAX31856_RING_SIZE & (MAX31856_RING_SIZE - 1)) == 0,
+	"MAX31856_RING_SIZE has to be a power of 2 from 1 to 128, Head and Tail are free running uint8_t counts");
+#if defined(ESP32)
+#define MAX31856_BARRIER() __sync_synchronize()						//Two cores, order the stores in hardware too
+#else
+#define MAX31856_BARRIER() __asm__ __volatile__("" ::: "memory")	//Single core, only the compiler can reorder
+#endif
+struct MAX31856_Sample_Struct {
+	uint32_t Micros;	//When the sample was read
+	int32_t LTC;		//Linearized TC Temperature in 1/128C
+	int16_t CJT;		//Cold Junction Temperature in 1/256C
+	uint8_t SR;			//Fault Status Register
+	uint8_t Device;		//Which device it came from, e.g. its index on the bus
+};
+struct MAX31856_Ring_Struct {
+	struct MAX31856_Sample_Struct Samples[MAX31856_RING_SIZE];
+	volatile uint8_t Head;			//Free running count of pushes, only changed by the producer
+	volatile uint8_t Tail;			//Free running count of pops, only changed by the consumer
+	volatile uint32_t Overruns;		//Samples dropped because the ring was full
+};
+
+bool MAX31856_ISR_ATTR MAX31856RingPush(struct MAX31856_Ring_Struct * R, struct MAX31856_Fixed_Struct * T, uint8_t Device, uint32_t Micros) {
+	uint8_t Head = R->Head;
+	if (uint8_t(Head - R->Tail) >= MAX31856_RING_SIZE) {
+		R->Overruns++;
+		return false;
+	}
+	struct MAX31856_Sample_Struct * S = &R->Samples[Head & (MAX31856_RING_SIZE - 1)];
+	S->Micros = Micros;
+	S->LTC = T->LTC;
+	S->CJT = T->CJT;
+	S->SR = T->SR;
+	S->Device = Device;
+	MAX31856_BARRIER(); //The sample has to be complete before the consumer can see it
+	R->Head = Head + 1;
+	return true;
+} //===============================================================================================
+bool MAX31856RingPop(struct MAX31856_Ring_Struct * R, struct MAX31856_Sample_Struct * S) {
+	uint8_t Tail = R->Tail;
+	if (R->Head == Tail) return false;
+	MAX31856_BARRIER();
+	*S = R->Samples[Tail & (MAX31856_RING_SIZE - 1)];
+	MAX31856_BARRIER(); //Finish the copy before the producer can reuse the slot
+	R->Tail = Tail + 1;
+	return true;
+} //===============================================================================================
+uint8_t MAX31856RingCount(struct MAX31856_Ring_Struct * R) {
+	return uint8_t(R->Head - R->Tail);
+} //===============================================================================================
+
+/*
+Running statistics over a sample stream, O(1) per sample and constant memory
+	Min/Max			over every sample since the reset, 1/128C
+	Mean/Variance	over every sample since the reset, from exact integer sums of each LTC less the first, so neither drifts
+					however far the temperature moves (float Welford was 0.3C out after 100000 samples of a 25C to 1000C ramp).
+					SumSquares holds 2^26 samples even at the full LTC swing
+	Rate			C/s between the last two samples
+	Window			average and rate of change over the last MAX31856_STATS_WINDOW samples
+*/
+#ifndef MAX31856_STATS_WINDOW
+#define MAX31856_STATS_WINDOW	8
+#endif
+static_assert(MAX31856_STATS_WINDOW > 0 && MAX31856_STATS_WINDOW <= 255, "MAX31856_STATS_WINDOW has to be 1 to 255, it is indexed and counted in uint8_t");
+struct MAX31856_Stats_Struct {
+	uint32_t Count;
+	int32_t Min;						//1/128C
+	int32_t Max;						//1/128C
+	int32_t First;						//First LTC, the origin for Sum and SumSquares
+	int64_t Sum;						//Sum of LTC - First, 1/128C
+	uint64_t SumSquares;				//Sum of (LTC - First)^2, (1/128C)^2
+	float Rate;							//C/s
+	int32_t LastLTC;
+	uint32_t LastMicros;
+	int32_t Window[MAX31856_STATS_WINDOW];	//Last few LTC values, 1/128C
+	uint32_t WindowMicros[MAX31856_STATS_WINDOW];
+	int32_t WindowSum;
+	uint8_t WindowIndex;				//Slot the next sample goes in, which also holds the oldest once the window is full
+	uint8_t WindowCount;
+};
+
+void MAX31856StatsReset(struct MAX31856_Stats_Struct * S) {
+	memset((void *)S, 0, sizeof(struct MAX31856_Stats_Struct));
+} //===============================================================================================
+void MAX31856StatsAdd(struct MAX31856_Stats_Struct * S, struct MAX31856_Sample_Struct * Sample) {
+	int32_t LTC = Sample->LTC;
+	if (S->Count == 0) {
+		S->Min = LTC;
+		S->Max = LTC;
+		S->First = LTC;
+	}
+	else {
+		if (LTC < S->Min) S->Min = LTC;
+		if (LTC > S->Max) S->Max = LTC;
+		uint32_t dt = Sample->Micros - S->LastMicros;
+		if (dt != 0) S->Rate = float(LTC - S->LastLTC) * 0.0078125 * 1000000.0 / float(dt);
+	}
+	S->Count++;
+	int32_t x = LTC - S->First;
+	S->Sum += x;
+	S->SumSquares += uint64_t(int64_t(x) * x);
+	S->LastLTC = LTC;
+	S->LastMicros = Sample->Micros;
+
+	if (S->WindowCount == MAX31856_STATS_WINDOW) S->WindowSum -= S->Window[S->WindowIndex];
+	else S->WindowCount++;
+	S->Window[S->WindowIndex] = LTC;
+	S->WindowMicros[S->WindowIndex] = Sample->Micros;
+	S->WindowSum += LTC;
+	S->WindowIndex++;
+	if (S->WindowIndex >= MAX31856_STATS_WINDOW) S->WindowIndex = 0;
+} //===============================================================================================
+double MAX31856StatsMean(struct MAX31856_Stats_Struct * S) {
+	if (S->Count == 0) return 0.0;
+	return MAX31856LTCToDouble(S->First) + double(S->Sum) * 0.0078125 / double(S->Count);
+} //===============================================================================================
+float MAX31856StatsVariance(struct MAX31856_Stats_Struct * S) { //Sample variance, C^2
+	if (S->Count < 2) return 0.0;
+	//SumSquares - Sum^2 / Count, with Sum split into Quotient * Count + Remainder so Sum^2 is never formed
+	int64_t Quotient = S->Sum / int64_t(S->Count);
+	int64_t Remainder = S->Sum % int64_t(S->Count);
+	int64_t M2 = int64_t(S->SumSquares) - S->Sum * Quotient - S->Sum * Remainder / int64_t(S->Count);
+	return float(M2) * 0.00006103515625 / float(S->Count - 1); //(1/128C)^2
+} //===============================================================================================
+float MAX31856StatsStdDev(struct MAX31856_Stats_Struct * S) {
+	return sqrt(MAX31856StatsVariance(S));
+} //===============================================================================================
+double MAX31856StatsWindowAverage(struct MAX31856_Stats_Struct * S) {
+	if (S->WindowCount == 0) return 0.0;
+	return double(S->WindowSum) * 0.0078125 / double(S->WindowCount);
+} //===============================================================================================
+float MAX31856StatsWindowRate(struct MAX31856_Stats_Struct * S) { //C/s from the oldest to the newest sample in the window
+	if (S->WindowCount < 2) return 0.0;
+	uint8_t Newest = (S->WindowIndex == 0) ? MAX31856_STATS_WINDOW - 1 : S->WindowIndex - 1;
+	uint8_t Oldest = (S->WindowCount == MAX31856_STATS_WINDOW) ? S->WindowIndex : 0;
+	uint32_t dt = S->WindowMicros[Newest] - S->WindowMicros[Oldest];
+	if (dt == 0) return 0.0;
+	return float(S->Window[Newest] - S->Window[Oldest]) * 0.0078125 * 1000000.0 / float(dt);
+} //===============================================================================================
+
+/*
+Poll scheduler for boards without a DRDY line.
+Reads are only issued when a fresh conversion is due, from the MAX31856ConversionTime() model of the current CR0/CR1.
+The end of the pending conversion is kept as a bracket, LoMicros to HiMicros, which every read narrows: a read whose LTC/CJT
+has not changed came before the edge, a changed one after it.  While the bracket is wider than 2 margins the next read is
+aimed at its middle (one margin above LoMicros until the period has been measured, since the datasheet figure can be far
+enough out that the middle is always late), once it is narrower a single read at HiMicros takes the conversion.  Each time a bracket is narrowed
+down its middle is pinned, and the time between pins over many conversions measures the real conversion time, after which
+the bracket only widens by PeriodMicros/MAX31856_POLL_DRIFT per conversion and most conversions cost one 7 byte read.
+A conversion that really does repeat the last LTC/CJT is taken after MAX31856_POLL_RETRIES reads past HiMicros.
+With no noise at all on the input nothing changes from one conversion to the next and there is nothing to time.
+Call MAX31856PollBegin() again after any write that changes CR0/CR1, since that restarts the conversion timing.
+See extras/host/MAX31856PollCheck.cpp for a run against the simulator with the oscillator 5% off.
+Typical Use:
+	MAX31856_Device_Struct TC;
+	MAX31856_Poll_Struct Poll;
+
+	Setup {
+		MAX31856Begin(&TC, 15);				//No DRDY
+		TC.M.REG.CR0.CMODE = true;
+		MAX31856WriteRegisters(&TC);
+		MAX31856PollBegin(&Poll, &TC);
+	}
+	Loop() {
+		if (MAX31856PollService(&Poll)) { //True only for a fresh conversion
+			MAX31856Calculate(&TC.M);
+			...
+		}
+		//or sleep for MAX31856PollDueMicros(&Poll)
+	}
+
+	One shot mode:
+		MAX31856PollOneShot(&Poll);			//Starts a conversion, MAX31856PollService() then returns true once when it has been read
+*/
+#define MAX31856_POLL_MARGIN		32		//A bracket narrower than 2 * PeriodMicros/MAX31856_POLL_MARGIN is read once at its end
+#define MAX31856_POLL_DRIFT			512		//Bracket growth per conversion once the period has been measured, PeriodMicros/this each side
+#define MAX31856_POLL_RETRIES		3		//Unchanged reads past HiMicros, a margin apart and doubling, before taking a repeat
+#define MAX31856_POLL_SPAN			16		//Conversions between pins needed before the measured period is trusted
+#define MAX31856_POLL_ANCHOR		256		//Conversions after which the period is measured from a new pin
+struct MAX31856_Poll_Struct {
+	struct MAX31856_Device_Struct * D;
+	uint32_t TconvMicros;			//Datasheet typical conversion time for the current CR0/CR1
+	uint32_t TconvMaxMicros;		//Datasheet maximum conversion time
+	uint32_t PeriodMicros;			//Conversion time in use, starts at TconvMicros and tracks the measured time
+	uint32_t DriftMicros;			//Bracket growth per conversion each side, PeriodMicros/8 until the period has been measured
+	uint32_t LoMicros;				//The pending conversion ends after LoMicros and no later than HiMicros
+	uint32_t HiMicros;
+	uint32_t NextMicros;			//When MAX31856PollService() will next read
+	uint32_t PinnedMicros;			//Middle of the last bracket that was narrowed down, or the start of a one shot
+	uint16_t PinnedConversions;		//Conversions since PinnedMicros
+	bool PinnedValid;
+	bool PeriodValid;				//PeriodMicros has been measured over at least MAX31856_POLL_SPAN conversions
+	bool Narrowed;					//A read has narrowed the bracket of the pending conversion
+	uint8_t Retries;				//Unchanged reads past HiMicros for the pending conversion
+	bool Waiting;					//A conversion is pending, false in one shot mode once it has been read
+	int32_t LTC;					//Last values read, a change means a fresh conversion
+	int16_t CJT;
+	uint32_t Reads;					//Reads issued
+	uint32_t Fresh;					//Reads that returned a new conversion
+	uint32_t Stale;					//Reads that returned the same conversion again
+	uint32_t Repeats;				//Conversions taken with the same LTC/CJT as the one before
+};
+
+void MAX31856PollAim(struct MAX31856_Poll_Struct * P) {
+	uint32_t Width = P->HiMicros - P->LoMicros;
+	uint32_t Margin = P->PeriodMicros / MAX31856_POLL_MARGIN;
+	if (Width <= 2 * Margin) P->NextMicros = P->HiMicros;
+	else if (!P->PeriodValid) P->NextMicros = P->LoMicros + Margin; //Period still unknown, step up from the low end so the edge gets pinned
+	else P->NextMicros = P->LoMicros + Width / 2;
+} //===============================================================================================
+
+/*
+Start tracking a device from now, after its CR0/CR1 have been written
+*/
+void MAX31856PollBegin(struct MAX31856_Poll_Struct * P, struct MAX31856_Device_Struct * D) {
+	float Tconv, TconvMax, FirstTconv, FirstTconvMax;
+	memset((void *)P, 0, sizeof(struct MAX31856_Poll_Struct));
+	P->D = D;
+	MAX31856ConversionTime(&Tconv, &TconvMax, &D->M);
+	bool CMODE = D->M.REG.CR0.CMODE;
+	D->M.REG.CR0.CMODE = false; //The first automatic conversion takes as long as a one shot
+	MAX31856ConversionTime(&FirstTconv, &FirstTconvMax, &D->M);
+	D->M.REG.CR0.CMODE = CMODE;
+	P->TconvMicros = uint32_t(Tconv * 1000.0);
+	P->TconvMaxMicros = uint32_t(TconvMax * 1000.0);
+	P->PeriodMicros = P->TconvMicros;
+	P->DriftMicros = P->PeriodMicros / 8; //Until the period is measured, the oscillator can be this far out
+	uint32_t Now = micros();
+	uint32_t Spread = uint32_t((FirstTconvMax - FirstTconv) * 1000.0); //The datasheet only gives a maximum, take the minimum as far below
+	P->LoMicros = Now + uint32_t(FirstTconv * 1000.0) - Spread;
+	P->HiMicros = Now + uint32_t(FirstTconvMax * 1000.0);
+	P->Waiting = CMODE;
+	P->LTC = MAX31856DecodeLTC(&D->M.REG);
+	P->CJT = D->M.REG.CJT.CJT;
+	MAX31856PollAim(P);
+} //===============================================================================================
+
+/*
+Start a one shot conversion and schedule its read
+*/
+void MAX31856PollOneShot(struct MAX31856_Poll_Struct * P) {
+	struct MAX31856_Device_Struct * D = P->D;
+	D->M.REG.CR0.ONESHOT = true;
+	MAX31856WriteRegisters(D);
+	D->M.REG.CR0.ONESHOT = false;
+	D->Shadow[0] &= ~0x40; //The chip clears ONESHOT itself when the conversion is done
+	uint32_t Now = micros();
+	uint32_t Half = P->PeriodMicros / MAX31856_POLL_MARGIN; //Measured, one read at the end of the bracket
+	if (!P->PeriodValid) Half = P->DriftMicros; //Datasheet figures, step through the bracket to measure it
+	P->LoMicros = Now + P->PeriodMicros - Half;
+	P->HiMicros = Now + P->PeriodMicros + Half;
+	P->PinnedMicros = Now; //The start is known exactly, so one narrowed finish measures the conversion time
+	P->PinnedConversions = 1;
+	P->PinnedValid = true;
+	P->Narrowed = false;
+	P->Retries = 0;
+	P->Waiting = true;
+	MAX31856PollAim(P);
+} //===============================================================================================
+
+/*
+Absolute micros() deadlines for the pending conversion, typical and worst case
+Typical Use:
+	uint32_t Typical, Max;
+	MAX31856PollNextReady(&Poll, &Typical, &Max);
+*/
+void MAX31856PollNextReady(struct MAX31856_Poll_Struct * P, uint32_t * TypicalMicros, uint32_t * MaxMicros) {
+	*TypicalMicros = P->LoMicros + (P->HiMicros - P->LoMicros) / 2;
+	*MaxMicros = P->HiMicros;
+} //===============================================================================================
+
+/*
+Microseconds until MAX31856PollService() will next read, 0 if it is due now, 0xFFFFFFFF if nothing is pending
+*/
+uint32_t MAX31856PollDueMicros(struct MAX31856_Poll_Struct * P) {
+	if (!P->Waiting) return 0xFFFFFFFF;
+	int32_t Due = int32_t(P->NextMicros - micros());
+	return (Due > 0) ? uint32_t(Due) : 0;
+} //===============================================================================================
+
+/*
+Narrowed down bracket of a conversion that has just been read: pin its middle and measure the period from the last pin
+*/
+void MAX31856PollPin(struct MAX31856_Poll_Struct * P) {
+	uint32_t Middle = P->LoMicros + (P->HiMicros - P->LoMicros) / 2;
+	uint16_t N = P->PinnedConversions;
+	if (P->PinnedValid && N > 0) {
+		uint32_t Measured = (Middle - P->PinnedMicros) / N;
+		int32_t Error = int32_t(Measured) - int32_t(P->PeriodMicros);
+		bool Sane = (Error < int32_t(P->PeriodMicros / 8) && Error > -int32_t(P->PeriodMicros / 8)); //Not a conversion missed or a bad pin
+		if (!P->D->M.REG.CR0.CMODE) { //One shot, N is 1 and the start is exact
+			if (Sane) {
+				P->PeriodMicros += Error / 2;
+				P->PeriodValid = true;
+				P->DriftMicros = P->PeriodMicros / MAX31856_POLL_DRIFT;
+			}
+		}
+		else if (Sane) {
+			if (N >= 2 && !P->PeriodValid) { //Better than the datasheet already, to within the two pins over N
+				P->PeriodMicros = Measured;
+				P->DriftMicros = 2 * (P->PeriodMicros / MAX31856_POLL_MARGIN) / N + P->PeriodMicros / MAX31856_POLL_DRIFT;
+			}
+			if (N >= MAX31856_POLL_SPAN) {
+				P->PeriodMicros = Measured;
+				P->PeriodValid = true;
+				P->DriftMicros = P->PeriodMicros / MAX31856_POLL_DRIFT;
+			}
+			if (N < MAX31856_POLL_ANCHOR) return; //Keep measuring from the old pin, the span only gets longer
+		}
+	}
+	P->PinnedMicros = Middle;
+	P->PinnedConversions = 0;
+	P->PinnedValid = true;
+} //===============================================================================================
+
+/*
+Read the device if a conversion is due.  Returns true if the read returned a new conversion, which is then in P->D->M
+*/
+bool MAX31856PollService(struct MAX31856_Poll_Struct * P) {
+	struct MAX31856_Device_Struct * D = P->D;
+	if (!P->Waiting || int32_t(micros() - P->NextMicros) < 0) return false;
+	uint32_t LastRead = D->LastReadMicros;
+	MAX31856ReadCJAndTemperature(D);
+	P->Reads++;
+	uint32_t Now = D->LastReadMicros;
+	int32_t LTC = MAX31856DecodeLTC(&D->M.REG);
+	int16_t CJT = D->M.REG.CJT.CJT;
+	uint32_t Margin = P->PeriodMicros / MAX31856_POLL_MARGIN;
+	uint32_t Longest = P->PeriodMicros + P->PeriodMicros / 8;
+	if (LastRead == 0 || Now - LastRead > Longest) LastRead = Now - Longest; //Never read or long ago, the last edge is within a period
+
+	if (LTC == P->LTC && CJT == P->CJT) {
+		if (int32_t(Now - P->HiMicros) < 0) { //Inside the bracket, so the edge is still to come
+			if (int32_t(Now - P->LoMicros) > 0) {
+				P->LoMicros = Now;
+				P->Narrowed = true;
+			}
+			P->Stale++;
+			MAX31856PollAim(P);
+			return false;
+		}
+		if (P->Retries < MAX31856_POLL_RETRIES) { //Late, or the conversion repeated the last value
+			P->Stale++;
+			P->NextMicros = Now + (Margin << P->Retries);
+			P->Retries++;
+			return false;
+		}
+		P->Repeats++;
+		P->Narrowed = false; //Nothing learned about the edge
+	}
+	else { //The edge came after the last read and no later than this one
+		uint32_t Lo = P->LoMicros;
+		if (!P->Narrowed && !P->PeriodValid) Lo -= P->DriftMicros; //No stale read proved the low end and the period is a guess, the edge may have been earlier
+		if (int32_t(LastRead - Lo) > 0) Lo = LastRead;
+		uint32_t Hi = (int32_t(Now - P->HiMicros) < 0) ? Now : P->HiMicros;
+		if (P->Retries || int32_t(Hi - Lo) <= 0) { //Late or outside the bracket, it was wrong: start again from what this read says
+			Lo = LastRead;
+			Hi = Now;
+		}
+		if (P->Retries || (P->PeriodValid && (Lo != P->LoMicros || Hi != P->HiMicros))) P->Narrowed = true; //A measured period is trusted for the low end
+		P->LoMicros = Lo;
+		P->HiMicros = Hi;
+	}
+
+	if (D->EdgeMicros == 0) D->EdgeMicros = P->LoMicros ? P->LoMicros : 1; //No DRDY to go by, the bracket will do
+	if (P->Narrowed && P->HiMicros - P->LoMicros <= 2 * Margin) MAX31856PollPin(P);
+	P->Fresh++;
+	P->Narrowed = false;
+	P->Retries = 0;
+	P->LTC = LTC;
+	P->CJT = CJT;
+	if (D->M.REG.CR0.CMODE) {
+		P->LoMicros += P->PeriodMicros - P->DriftMicros;
+		P->HiMicros += P->PeriodMicros + P->DriftMicros;
+		if (P->PinnedConversions < 0xFFFF) P->PinnedConversions++;
+		MAX31856PollAim(P);
+	}
+	else P->Waiting = false;
+	return true;
+} //===============================================================================================
+
+/*
+Software linearization for the voltage modes (TCTYPE 8-15), for thermocouples the MAX31856 does not linearize itself (type C/W-Re, ...)
+or where the chips own linearization is not wanted.
+Each curve is a few piecewise uniform tables of EMF against temperature, generated at compile time from the reference function
+(constexpr) and stored in PROGMEM.  A conversion is a search over at most a few hundred entries (8 or 9 steps) plus a linear
+interpolation, in place of a 10th order polynomial, with cold junction compensation from CJT:
+	T = Table^-1(Vin + Table(CJT))
+Closer steps where the curve bends the most keep the interpolation error down, see MAX31856TypeK for an example.
+
+Typical Use:
+	Setup {
+		MAX31856.REG.CR1.TCTYPE = 8;		//Voltage mode, 8x gain
+		MAX31856WriteRegisters();
+	}
+	Loop() {
+		MAX31856ReadRegisters();
+		MAX31856CalculateLinearized(&MAX31856TypeK);	//LTCT from the LTC voltage and CJT through the type K tables
+	}
+
+Adding a curve: a struct with a constexpr EMF(T) returning mV, then one MAX31856CurveSegment() per uniform piece, each piece starting
+where the last one ended.  Use the published coefficients for the thermocouple, e.g. ASTM E988 for type C:
+	struct TypeCCurve {
+		static constexpr double EMF(double T) { return T * (c1 + T * (c2 + T * (...))); }	//mV
+	};
+	const MAX31856_Segment_Struct TypeCSegments[] = {
+		MAX31856CurveSegment<TypeCCurve, 0, 2320, 10>(),
+	};
+	const MAX31856_Linearization_Struct TypeC = { TypeCSegments, 1 };
+*/
+struct MAX31856_Segment_Struct {
+	const int32_t * EMF;	//PROGMEM, thermocouple EMF in nV at TMin, TMin + Step, ... rising
+	uint16_t Length;
+	int16_t TMin;			//C
+	uint8_t Step;			//C
+};
+struct MAX31856_Linearization_Struct {
+	const struct MAX31856_Segment_Struct * Segments;	//In rising order, each one starting at the last temperature of the one before
+	uint8_t NumSegments;
+};
+
+//Compile time helpers, C++11 constexpr so they have to be single return statements
+constexpr double MAX31856ConstSquare(double x) {
+	return x * x;
+}
+constexpr double MAX31856ConstExpSeries(double x, uint8_t n, double Term, double Sum) {
+	return (n > 16) ? Sum : MAX31856ConstExpSeries(x, n + 1, Term * x / n, Sum + Term * x / n);
+}
+constexpr double MAX31856ConstExp(double x) { //Halve down to |x| <= 1 then square back up
+	return (x < -1.0 || x > 1.0) ? MAX31856ConstSquare(MAX31856ConstExp(x / 2.0)) : MAX31856ConstExpSeries(x, 1, 1.0, 1.0);
+}
+constexpr int32_t MAX31856Nanovolts(double mV) {
+	return int32_t(mV * 1000000.0 + ((mV < 0.0) ? -0.5 : 0.5));
+}
+template <uint16_t... I> struct MAX31856Indices {};
+template <uint16_t N, uint16_t... I> struct MAX31856MakeIndices : MAX31856MakeIndices<N - 1, N - 1, I...> {};
+template <uint16_t... I> struct MAX31856MakeIndices<0, I...> { typedef MAX31856Indices<I...> Type; };
+
+template <class Curve, int16_t TMin, uint8_t Step, class Indices> struct MAX31856CurveTable;
+template <class Curve, int16_t TMin, uint8_t Step, uint16_t... I> struct MAX31856CurveTable<Curve, TMin, Step, MAX31856Indices<I...> > {
+	static_assert(Curve::EMF(TMin) == Curve::EMF(TMin), "Curve::EMF() has to be constexpr so the table is built by the compiler");
+	static const int32_t EMF[sizeof...(I)];
+};
+template <class Curve, int16_t TMin, uint8_t Step, uint16_t... I>
+const int32_t MAX31856CurveTable<Curve, TMin, Step, MAX31856Indices<I...> >::EMF[sizeof...(I)] PROGMEM = {
+	MAX31856Nanovolts(Curve::EMF(double(TMin + int16_t(I) * Step)))...
+};
+
+/*
+One uniform piece of a curve from TMin to TMax C every Step C
+*/
+template <class Curve, int16_t TMin, int16_t TMax, uint8_t Step> constexpr struct MAX31856_Segment_Struct MAX31856CurveSegment() {
+	static_assert(TMax > TMin && (TMax - TMin) % Step == 0, "TMax - TMin has to be a whole number of Steps");
+	return { &MAX31856CurveTable<Curve, TMin, Step, typename MAX31856MakeIndices<(TMax - TMin) / Step + 1>::Type>::EMF[0], (TMax - TMin) / Step + 1, TMin, Step };
+}
+
+/*
+Type K, NIST ITS-90 reference function, -270C to 1372C.  Worst case interpolation error against the reference function:
+	0.04C below -200C, 0.025C from -200C to 0C, 0.015C above 0C (checked by extras/host/MAX31856TypeKCheck.cpp)
+*/
+struct MAX31856TypeKCurve {
+	static constexpr double EMF(double T) { //mV
+		return (T < 0.0) ?
+			T * (0.394501280250E-01 + T * (0.236223735980E-04 + T * (-0.328589067840E-06 + T * (-0.499048287770E-08 + T * (-0.675090591730E-10
+			+ T * (-0.574103274280E-12 + T * (-0.310888728940E-14 + T * (-0.104516093650E-16 + T * (-0.198892668780E-19 + T * -0.163226974860E-22)))))))))
+			:
+			-0.176004136860E-01 + T * (0.389212049750E-01 + T * (0.185587700320E-04 + T * (-0.994575928740E-07 + T * (0.318409457190E-09
+			+ T * (-0.560728448890E-12 + T * (0.560750590590E-15 + T * (-0.320207200030E-18 + T * (0.971511471520E-22 + T * -0.121047212750E-25))))))))
+			+ 0.118597600000E+00 * MAX31856ConstExp(-0.118343200000E-03 * MAX31856ConstSquare(T - 0.126968600000E+03));
+	}
+};
+const struct MAX31856_Segment_Struct MAX31856TypeKSegments[] = {
+	MAX31856CurveSegment<MAX31856TypeKCurve, -270, -260, 1>(),	//Flattens out towards -270C
+	MAX31856CurveSegment<MAX31856TypeKCurve, -260, -200, 2>(),
+	MAX31856CurveSegment<MAX31856TypeKCurve, -200, 0, 4>(),
+	MAX31856CurveSegment<MAX31856TypeKCurve, 0, 1370, 10>(),
+	MAX31856CurveSegment<MAX31856TypeKCurve, 1370, 1372, 2>(),	//Up to the end of the reference function without a finer step for all of it
+};
+const struct MAX31856_Linearization_Struct MAX31856TypeK = { MAX31856TypeKSegments, 5 };
+
+/*
+Thermocouple EMF in V at a temperature in C, NAN outside of the tables
+*/
+double MAX31856EMFFromTemperature(const struct MAX31856_Linearization_Struct * L, double T) {
+	for (uint8_t s = 0; s < L->NumSegments; s++) {
+		const struct MAX31856_Segment_Struct * S = &L->Segments[s];
+		double x = (T - double(S->TMin)) / double(S->Step);
+		if (x < 0.0) break;
+		if (x > double(S->Length - 1)) continue;
+		uint16_t i = uint16_t(x);
+		if (i > S->Length - 2) i = S->Length - 2;
+		int32_t E0 = int32_t(pgm_read_dword(&S->EMF[i]));
+		int32_t E1 = int32_t(pgm_read_dword(&S->EMF[i + 1]));
+		return (double(E0) + double(E1 - E0) * (x - double(i))) * 1.0E-9;
+	}
+	return NAN;
+} //===============================================================================================
+
+/*
+Temperature in C for a thermocouple EMF in V, NAN outside of the tables
+*/
+double MAX31856TemperatureFromEMF(const struct MAX31856_Linearization_Struct * L, double Volts) {
+	double E = Volts * 1.0E9;
+	for (uint8_t s = 0; s < L->NumSegments; s++) {
+		const struct MAX31856_Segment_Struct * S = &L->Segments[s];
+		if (E < double(int32_t(pgm_read_dword(&S->EMF[0])))) break;
+		if (E > double(int32_t(pgm_read_dword(&S->EMF[S->Length - 1])))) continue;
+		uint16_t Low = 0;				//EMF[Low] <= E
+		uint16_t High = S->Length - 1;	//EMF[High] >= E
+		while (High - Low > 1) {
+			uint16_t Mid = (Low + High) / 2;
+			if (double(int32_t(pgm_read_dword(&S->EMF[Mid]))) <= E) Low = Mid;
+			else High = Mid;
+		}
+		int32_t E0 = int32_t(pgm_read_dword(&S->EMF[Low]));
+		int32_t E1 = int32_t(pgm_read_dword(&S->EMF[High]));
+		return double(S->TMin) + double(S->Step) * (double(Low) + (E - double(E0)) / double(E1 - E0));
+	}
+	return NAN;
+} //===============================================================================================
+
+/*
+Hot junction temperature in C from the measured thermocouple voltage and the cold junction temperature
+*/
+double MAX31856Linearize(const struct MAX31856_Linearization_Struct * L, double Volts, double CJT) {
+	return MAX31856TemperatureFromEMF(L, Volts + MAX31856EMFFromTemperature(L, CJT));
+} //===============================================================================================
+
+/*
+MAX31856Calculate() then LTCT from MAX31856LTCVolts() and CJT through a curve.  Only meaningful in the voltage modes, LTCT is NAN otherwise
+*/
+void MAX31856CalculateLinearized(const struct MAX31856_Linearization_Struct * L, struct MAX31856_REG_Struct * M = &MAX31856) {
+	MAX31856Calculate(M);
+	if (MAX31856VoltageGain(M)) M->LTCT = MAX31856Linearize(L, MAX31856LTCVolts(M), M->CJT);
+} //===============================================================================================
+
+/*
+Compile time configuration.  MAX31856Config describes a configuration with typed options, every option returns a new
+MAX31856Config so they chain, and all of it is constexpr.  MAX31856_CONFIG_IMAGE() checks it with static_assert and turns it
+into the 13 byte write burst (address byte + registers 0x00-0x0B) as a static const array in PROGMEM.
+Writing it is then one SPI burst straight out of flash, nothing is packed field by field at runtime and the image is not
+copied to RAM (see MAX31856TransferImage()).  MAX31856LoadImage() also runs MAX31856Calculate(), so the doubles follow the image.
+Anything not set keeps the power on default of the chip.
+Typical Use:
+	MAX31856_CONFIG_IMAGE(OvenConfig, MAX31856Config()
+		.Thermocouple(MAX31856TCType::K)
+		.Averaging(MAX31856Averaging::Samples4)
+		.Notch(MAX31856Notch::Hz60)
+		.OpenCircuit(MAX31856OCFault::Under5k)
+		.Conversion(MAX31856Conversion::Automatic)
+		.Mask(MAX31856_FAULT_CJHIGH | MAX31856_FAULT_CJLOW)
+		.TCThresholds(-20.0, 350.0)
+		.CJThresholds(0, 70));
+
+	Setup {
+		MAX31856WriteImage(OvenConfig);				//Single MAX31856, updates MAX31856.REG too
+		MAX31856WriteImage(&TC[3], OvenConfig);		//One device, updates its shadow so later diff writes stay small
+		MAX31856BusWriteImage(&Bus, OvenConfig);	//Every device on the bus in one broadcast burst
+	}
+
+Invalid combinations (low threshold above high, a threshold the register cannot hold, a cold junction temperature written
+while the internal sensor is overwriting it, ...) fail to compile.
+*/
+#define MAX31856_FAULT_OPEN		0x01	//MASK and SR bits
+#define MAX31856_FAULT_OVUV		0x02
+#define MAX31856_FAULT_TCLOW	0x04
+#define MAX31856_FAULT_TCHIGH	0x08
+#define MAX31856_FAULT_CJLOW	0x10
+#define MAX31856_FAULT_CJHIGH	0x20
+#define MAX31856_CONFIG_IMAGE_LEN	13
+enum class MAX31856TCType : uint8_t { B = 0, E = 1, J = 2, K = 3, N = 4, R = 5, S = 6, T = 7, Voltage8x = 8, Voltage32x = 12 };
+enum class MAX31856Averaging : uint8_t { Samples1 = 0, Samples2 = 1, Samples4 = 2, Samples8 = 3, Samples16 = 4 };
+enum class MAX31856Notch : uint8_t { Hz60 = 0, Hz50 = 1 };
+enum class MAX31856OCFault : uint8_t { Disabled = 0, Under5k = 1, Under40k = 2, Under40kLongFilter = 3 };	//Open circuit detection for the source resistance of the thermocouple
+enum class MAX31856Conversion : uint8_t { OneShot = 0, Automatic = 1 };
+enum class MAX31856FaultMode : uint8_t { Comparator = 0, Interrupt = 1 };
+
+class MAX31856Config {
+public:
+	constexpr MAX31856Config() : MAX31856Config(0x00, 0x03, 0xFF, 127.0, -64.0, 2047.9375, -2048.0, 0.0, 0.0) {}
+
+	constexpr MAX31856Config Thermocouple(MAX31856TCType Type) const {
+		return MAX31856Config(CR0, uint8_t((CR1 & 0xF0) | uint8_t(Type)), MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config Averaging(MAX31856Averaging Samples) const {
+		return MAX31856Config(CR0, uint8_t((CR1 & 0x8F) | (uint8_t(Samples) << 4)), MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config Notch(MAX31856Notch Hz) const {
+		return MAX31856Config(uint8_t((CR0 & ~0x01) | uint8_t(Hz)), CR1, MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config OpenCircuit(MAX31856OCFault Mode) const {
+		return MAX31856Config(uint8_t((CR0 & ~0x30) | (uint8_t(Mode) << 4)), CR1, MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config Conversion(MAX31856Conversion Mode) const {
+		return MAX31856Config(uint8_t((CR0 & ~0x80) | (uint8_t(Mode) << 7)), CR1, MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config FaultMode(MAX31856FaultMode Mode) const {
+		return MAX31856Config(uint8_t((CR0 & ~0x04) | (uint8_t(Mode) << 2)), CR1, MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config Mask(uint8_t Masked) const { //MAX31856_FAULT_* bits that should not drive the FAULT pin
+		return MAX31856Config(CR0, CR1, Masked, CJHF, CJLF, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config TCThresholds(double Low, double High) const { //C, 1/16C resolution
+		return MAX31856Config(CR0, CR1, MASK, CJHF, CJLF, High, Low, CJTO, CJT);
+	}
+	constexpr MAX31856Config CJThresholds(double Low, double High) const { //C, whole degrees
+		return MAX31856Config(CR0, CR1, MASK, High, Low, LTHFT, LTLFT, CJTO, CJT);
+	}
+	constexpr MAX31856Config CJOffset(double Offset) const { //C, 1/16C resolution
+		return MAX31856Config(CR0, CR1, MASK, CJHF, CJLF, LTHFT, LTLFT, Offset, CJT);
+	}
+	constexpr MAX31856Config ExternalColdJunction(double Temperature) const { //Turns the internal sensor off and writes CJT instead
+		return MAX31856Config(uint8_t(CR0 | 0x08), CR1, MASK, CJHF, CJLF, LTHFT, LTLFT, CJTO, Temperature);
+	}
+
+	//Checked on the register codes as Byte() rounds them, so a value that only overflows once rounded is caught too
+	constexpr bool Valid() const {
+		return Fits(LTHFT * 16.0, -32768, 32767) && Fits(LTLFT * 16.0, -32768, 32767) && Round(LTLFT * 16.0) <= Round(LTHFT * 16.0)
+			&& Fits(CJHF, -128, 127) && Fits(CJLF, -128, 127) && Round(CJLF) <= Round(CJHF)
+			&& Fits(CJTO * 16.0, -128, 127)
+			&& Fits(CJT * 256.0, -32768, 32767)
+			&& ((CR0 & 0x08) || CJT == 0.0);	//CJT is only written while the internal sensor is off
+	}
+
+	//Register 0x00-0x0B, or the write address for -1
+	constexpr uint8_t Byte(int8_t Address) const {
+		return (Address == -1) ? 0x80
+			: (Address == 0) ? CR0
+			: (Address == 1) ? CR1
+			: (Address == 2) ? MASK
+			: (Address == 3) ? uint8_t(Round(CJHF))
+			: (Address == 4) ? uint8_t(Round(CJLF))
+			: (Address == 5) ? uint8_t(uint16_t(Round(LTHFT * 16.0)) >> 8)
+			: (Address == 6) ? uint8_t(Round(LTHFT * 16.0))
+			: (Address == 7) ? uint8_t(uint16_t(Round(LTLFT * 16.0)) >> 8)
+			: (Address == 8) ? uint8_t(Round(LTLFT * 16.0))
+			: (Address == 9) ? uint8_t(Round(CJTO * 16.0))
+			: (Address == 10) ? uint8_t(uint16_t(Round(CJT * 256.0) & 0xFFFC) >> 8)
+			: uint8_t(Round(CJT * 256.0) & 0xFC);
+	}
+
+private:
+	constexpr MAX31856Config(uint8_t CR0, uint8_t CR1, uint8_t MASK, double CJHF, double CJLF, double LTHFT, double LTLFT, double CJTO, double CJT) :
+		CR0(CR0), CR1(CR1), MASK(MASK), CJHF(CJHF), CJLF(CJLF), LTHFT(LTHFT), LTLFT(LTLFT), CJTO(CJTO), CJT(CJT) {}
+	static constexpr int32_t Round(double x) {
+		return int32_t((x < 0.0) ? x - 0.5 : x + 0.5);
+	}
+	static constexpr bool Fits(double x, int32_t Min, int32_t Max) { //Range check on the double first so Round() cannot overflow
+		return x > double(Min) - 1.0 && x < double(Max) + 1.0 && Round(x) >= Min && Round(x) <= Max;
+	}
+	uint8_t CR0;
+	uint8_t CR1;
+	uint8_t MASK;
+	double CJHF;	//Thresholds, offset and cold junction temperature in C, as in MAX31856_REG_Struct
+	double CJLF;
+	double LTHFT;
+	double LTLFT;
+	double CJTO;
+	double CJT;
+};
+static_assert(MAX31856Config().Valid(), "Power on defaults have to be valid");
+static_assert(!MAX31856Config().CJThresholds(0, 127.6).Valid(), "CJHF 127.6 rounds to 128, which the register would read as -128");
+static_assert(!MAX31856Config().CJOffset(7.99).Valid(), "CJTO 7.99 rounds to 128/16, which the register would read as -8");
+static_assert(!MAX31856Config().TCThresholds(0, 2047.99).Valid(), "LTHFT 2047.99 rounds past the top of the register");
+static_assert(!MAX31856Config().ExternalColdJunction(127.999).Valid(), "CJT 127.999 rounds past the top of the register");
+
+#define MAX31856_CONFIG_IMAGE(Name, Cfg) \
+	static_assert((Cfg).Valid(), "Invalid MAX31856 configuration " #Name); \
+	static const uint8_t Name[MAX31856_CONFIG_IMAGE_LEN] PROGMEM = { \
+		(Cfg).Byte(-1), (Cfg).Byte(0), (Cfg).Byte(1), (Cfg).Byte(2), (Cfg).Byte(3), (Cfg).Byte(4), (Cfg).Byte(5), \
+		(Cfg).Byte(6), (Cfg).Byte(7), (Cfg).Byte(8), (Cfg).Byte(9), (Cfg).Byte(10), (Cfg).Byte(11) }
+
+/*
+Load the configuration registers of an image into a register struct, e.g. to keep MAX31856.REG in step with what was written,
+then MAX31856Calculate() so the threshold/offset doubles match the new registers
+*/
+void MAX31856LoadImage(const uint8_t * Image, struct MAX31856_REG_Struct * M = &MAX31856) {
+	uint8_t Registers[16];
+	MAX31856PackRegisters(M, &Registers[0]);
+	memcpy_P(&Registers[0], Image + 1, 12);
+	MAX31856UnpackRegisters(M, &Registers[0]);
+	MAX31856Calculate(M);
+} //===============================================================================================
+
+/*
+Clock a MAX31856_CONFIG_IMAGE() out of flash, inside a transaction with the chip selects already down.
+Where PROGMEM is its own address space (AVR) or has to be read aligned (ESP8266) it is streamed a byte at a time with
+pgm_read_byte(), everywhere else flash is mapped like RAM and the image goes to the transport as it is.  Neither copies it to RAM.
+Define MAX31856_STREAM_IMAGE as 1 or 0 to choose
+*/
+#ifndef MAX31856_STREAM_IMAGE
+#if defined(__AVR__) || defined(ESP8266)
+#define MAX31856_STREAM_IMAGE	1
+#else
+#define MAX31856_STREAM_IMAGE	0
+#endif
+#endif
+void MAX31856TransferImage(const uint8_t * Image) {
+#if MAX31856_STREAM_IMAGE
+	for (uint8_t i = 0; i < MAX31856_CONFIG_IMAGE_LEN; i++) {
+		uint8_t Byte = pgm_read_byte(&Image[i]);
+		MAX31856Transport->Transfer(&Byte, NULL, 1);
+	}
+#else
+	MAX31856Transport->Transfer(Image, NULL, MAX31856_CONFIG_IMAGE_LEN);
+#endif
+} //===============================================================================================
+
+/*
+Write a MAX31856_CONFIG_IMAGE() in one transaction
+*/
+void MAX31856WriteImage(const uint8_t * Image, struct MAX31856_REG_Struct * M = &MAX31856, uint8_t CSPin = MAX31856_NO_PIN) {
+	MAX31856BusClaim();
+	MAX31856Transport->Begin();
+	if (CSPin != MAX31856_NO_PIN) MAX31856Transport->Select(CSPin, true);
+	MAX31856TransferImage(Image);
+	if (CSPin != MAX31856_NO_PIN) MAX31856Transport->Select(CSPin, false);
+	MAX31856Transport->End();
+	MAX31856BusRelease(MAX31856_CONFIG_IMAGE_LEN);
+	if (M) MAX31856LoadImage(Image, M);
+} //===============================================================================================
+void MAX31856WriteImage(struct MAX31856_Device_Struct * D, const uint8_t * Image) {
+	MAX31856InstrumentBegin(D);
+	MAX31856WriteImage(Image, &D->M, D->CSPin);
+	MAX31856InstrumentEnd(D, true);
+	memcpy_P(&D->Shadow[0], Image + 1, 12);
+	D->ShadowValid = true;
+} //===============================================================================================
+void MAX31856BusWriteImage(struct MAX31856_Bus_Struct * B, const uint8_t * Image) {
+	MAX31856BusClaim();
+	MAX31856Transport->Begin();
+	for (uint8_t i = 0; i < B->NumDevices; i++) MAX31856Transport->Select(B->Devices[i].CSPin, true);
+	MAX31856TransferImage(Image);
+	for (uint8_t i = 0; i < B->NumDevices; i++) MAX31856Transport->Select(B->Devices[i].CSPin, false);
+	MAX31856Transport->End();
+	MAX31856BusRelease(MAX31856_CONFIG_IMAGE_LEN);
+	for (uint8_t i = 0; i < B->NumDevices; i++) {
+		struct MAX31856_Device_Struct * D = &B->Devices[i];
+		MAX31856LoadImage(Image, &D->M);
+		memcpy_P(&D->Shadow[0], Image + 1, 12);
+		D->ShadowValid = true;
+	}
+} //===============================================================================================
+
+/*
+Fault events.  Each new SR is XORed against the SR last reported and only the bits that changed are looked at, so a sample with
+no change in faults costs a compare and a return.  Changed bits become raise/clear events with the time they changed, after an
+optional debounce of Debounce samples in the new state, and each fault keeps a count and how long it has been raised.
+With CR0.FAULT set (interrupt mode) the MAX31856 latches SR until FAULTCLR, set AutoClear and MAX31856FaultService() sends the
+2 byte CR0 write that clears it.  The write is built from the CR0 last written to the chip (D->Shadow[0]), so changes staged in
+D->M but not written yet are not sent along with it.  A new SR is cleared straight away, so a fault that goes at once is
+reported as cleared on the next conversion; while the same SR persists it is cleared once per ClearMicros
+(MAX31856_FAULT_CLEAR_MICROS by default) rather than on every conversion, and a fault that goes after that is seen within
+ClearMicros.  See extras/host/MAX31856FaultCheck.cpp for the debounce and latch handling against the simulator.
+Typical Use:
+	MAX31856_Fault_Struct Faults;
+	void FaultEvent(struct MAX31856_Fault_Struct * F, struct MAX31856_FaultEvent_Struct * E) {
+		if (E->Raised && E->Fault == MAX31856_FAULT_OPEN) HeaterOff();
+		MAX31856PrintFaultEvent(Serial, E);
+	}
+
+	Setup {
+		MAX31856FaultBegin(&Faults, &TC, FaultEvent);
+		Faults.Debounce = 2;			//Ignore a fault seen on a single conversion
+		Faults.AutoClear = true;
+	}
+	Loop() {
+		if (MAX31856DataReady(&TC)) {
+			MAX31856ReadCJAndTemperature(&TC);
+			MAX31856FaultService(&Faults);
+		}
+	}
+*/
+#define MAX31856_FAULT_TCRANGE	0x40	//SR only, no MASK bit
+#define MAX31856_FAULT_CJRANGE	0x80
+#define MAX31856_FAULT_CLEAR_MICROS	1000000	//FAULTCLR repeat while the same latched SR persists
+struct MAX31856_FaultEvent_Struct {
+	uint32_t Micros;			//Sample time the bit first showed its new state
+	uint32_t DurationMicros;	//Clear events, how long the fault was raised
+	uint8_t Fault;				//MAX31856_FAULT_* bit
+	bool Raised;				//True for a new fault, false when it has gone
+};
+struct MAX31856_Fault_Struct;
+typedef void (*MAX31856_FaultCallback)(struct MAX31856_Fault_Struct * F, struct MAX31856_FaultEvent_Struct * E);
+struct MAX31856_Fault_Struct {
+	struct MAX31856_Device_Struct * D;
+	MAX31856_FaultCallback Callback;
+	uint8_t Debounce;			//Samples a bit has to hold its new state before it is reported, 0 or 1 reports straight away
+	bool AutoClear;				//Send FAULTCLR while CR0.FAULT latching is on
+	uint32_t ClearMicros;		//Least time between FAULTCLR writes for an SR that has not changed
+	uint8_t ClearedSR;			//SR the last FAULTCLR was sent for, 0 once SR has read clear
+	uint32_t ClearedMicros;		//When it was sent
+	uint8_t Reported;			//SR as last reported
+	uint8_t Pending;			//Bits that differ from Reported but have not passed the debounce yet
+	uint8_t Samples[8];			//Samples each pending bit has been in its new state
+	uint32_t ChangeMicros[8];	//When each pending bit changed
+	uint32_t RaisedMicros[8];	//When each raised fault was raised
+	uint16_t Count[8];			//Times each fault has been raised
+	uint32_t TotalMicros[8];	//Time each fault has spent raised, up to its last clear
+	uint32_t LongestMicros[8];	//Longest single time raised
+	uint32_t Clears;			//FAULTCLR writes sent
+};
+
+void MAX31856FaultBegin(struct MAX31856_Fault_Struct * F, struct MAX31856_Device_Struct * D = NULL, MAX31856_FaultCallback Callback = NULL) {
+	memset((void *)F, 0, sizeof(struct MAX31856_Fault_Struct));
+	F->D = D;
+	F->Callback = Callback;
+	F->ClearMicros = MAX31856_FAULT_CLEAR_MICROS;
+} //===============================================================================================
+
+/*
+Feed one SR sample.  Returns the number of events raised, each of which has already gone to the callback
+*/
+uint8_t MAX31856FaultUpdate(struct MAX31856_Fault_Struct * F, uint8_t SR, uint32_t Micros) {
+	uint8_t Changed = SR ^ F->Reported;
+	F->Pending &= Changed; //Anything that went back before its debounce ran out is forgotten
+	if (!Changed) return 0;
+
+	uint8_t Events = 0;
+	while (Changed) {
+		uint8_t Bit = Changed & -Changed;
+		uint8_t i = __builtin_ctz(Bit);
+		Changed &= Changed - 1;
+		if (!(F->Pending & Bit)) {
+			F->Pending |= Bit;
+			F->Samples[i] = 0;
+			F->ChangeMicros[i] = Micros;
+		}
+		if (++F->Samples[i] < F->Debounce) continue;
+
+		F->Pending &= ~Bit;
+		F->Reported ^= Bit;
+		struct MAX31856_FaultEvent_Struct E;
+		E.Micros = F->ChangeMicros[i];
+		E.Fault = Bit;
+		E.Raised = (SR & Bit) != 0;
+		if (E.Raised) {
+			E.DurationMicros = 0;
+			F->RaisedMicros[i] = E.Micros;
+			F->Count[i]++;
+		}
+		else {
+			E.DurationMicros = E.Micros - F->RaisedMicros[i];
+			F->TotalMicros[i] += E.DurationMicros;
+			if (E.DurationMicros > F->LongestMicros[i]) F->LongestMicros[i] = E.DurationMicros;
+		}
+		Events++;
+		if (F->Callback) F->Callback(F, &E);
+	}
+	return Events;
+} //===============================================================================================
+
+/*
+Feed the SR last read from F->D, then clear a latched SR if AutoClear is on and it is new or ClearMicros have passed
+*/
+uint8_t MAX31856FaultService(struct MAX31856_Fault_Struct * F) {
+	struct MAX31856_Device_Struct * D = F->D;
+	uint8_t SR = D->M.REG.SR.WORD;
+	uint32_t Now = D->LastReadMicros;
+	uint8_t Events = MAX31856FaultUpdate(F, SR, Now);
+	uint8_t Written = D->ShadowValid ? D->Shadow[0] : D->M.REG.CR0.WORD; //CR0 as the chip has it
+	if (!SR) F->ClearedSR = 0;
+	else if (F->AutoClear && (Written & 0x04) && (SR != F->ClearedSR || Now - F->ClearedMicros >= F->ClearMicros)) {
+		uint8_t CR0 = (Written | 0x02) & ~0x40; //FAULTCLR, without starting a one shot
+		MAX31856InstrumentBegin(D);
+		MAX31856WriteRange(D->CSPin, 0x00, &CR0, 1);
+		MAX31856InstrumentEnd(D, true);
+		F->ClearedSR = SR;
+		F->ClearedMicros = Now;
+		F->Clears++;
+	}
+	return Events;
+} //===============================================================================================
+
+/*
+Time a fault has been raised in total, including the current stretch if it is raised now
+*/
+uint32_t MAX31856FaultRaisedMicros(struct MAX31856_Fault_Struct * F, uint8_t Fault, uint32_t Now) {
+	uint8_t i = __builtin_ctz(Fault);
+	uint32_t Total = F->TotalMicros[i];
+	if (F->Reported & Fault) Total += Now - F->RaisedMicros[i];
+	return Total;
+} //===============================================================================================
+
+const __FlashStringHelper * MAX31856FaultName(uint8_t Fault) {
+	switch (Fault) {
+	case MAX31856_FAULT_OPEN:		return F("OPEN");
+	case MAX31856_FAULT_OVUV:		return F("OVUV");
+	case MAX31856_FAULT_TCLOW:		return F("TCLOW");
+	case MAX31856_FAULT_TCHIGH:		return F("TCHIGH");
+	case MAX31856_FAULT_CJLOW:		return F("CJLOW");
+	case MAX31856_FAULT_CJHIGH:		return F("CJHIGH");
+	case MAX31856_FAULT_TCRANGE:	return F("TC_Range");
+	case MAX31856_FAULT_CJRANGE:	return F("CJ_Range");
+	}
+	return F("?");
+} //===============================================================================================
+
+/*
+One line per event, e.g. "OPEN raised at 1234567us" or "OPEN cleared at 2345678us after 1111111us"
+*/
+void MAX31856PrintFaultEvent(Print &p, struct MAX31856_FaultEvent_Struct * E) {
+	p.print(MAX31856FaultName(E->Fault));
+	p.print(E->Raised ? F(" raised at ") : F(" cleared at "));
+	p.print((unsigned long)E->Micros);
+	p.print(F("us"));
+	if (!E->Raised) {
+		p.print(F(" after "));
+		p.print((unsigned long)E->DurationMicros);
+		p.print(F("us"));
+	}
+	p.print(F("\r\n"));
+} //===============================================================================================
+
+/*
+Warm start.  A MAX31856_Record_Struct is the 12 configuration registers with a magic, version and CRC so it can sit in EEPROM
+or flash and be trusted at the next boot.  MAX31856WarmStart() reads the device back in one 17 byte burst and compares it to the
+record.  A device that already holds the configuration (after a reset of the micro but not of the MAX31856) is left alone, so
+its conversion carries on and the sample just read is good.  Anything else gets a diff write of only the registers that differ.
+ONESHOT and FAULTCLR are commands and are not compared, CJTH/CJTL are not compared while the internal cold junction sensor
+writes them.
+See extras/host/MAX31856WarmStartCheck.cpp for cold, warm, partly changed and corrupt records against the simulator.
+Typical Use:
+	MAX31856_Record_Struct Record;
+
+	Setup {
+		EEPROM.get(0, Record);
+		if (MAX31856BusWarmStart(&Bus, &Record) < 0) {	//Nothing saved yet
+			MAX31856LoadImage(OvenConfig, &TC[0].M);	//Or fill in TC[0].M.REG by hand
+			MAX31856RecordMake(&Record, &TC[0].M);
+			EEPROM.put(0, Record);
+			MAX31856BusWarmStart(&Bus, &Record);
+		}
+	}
+*/
+#define MAX31856_RECORD_MAGIC		0x3185
+#define MAX31856_RECORD_VERSION		1
+#define MAX31856_WARM_BAD_RECORD	-1	//Magic, version or CRC wrong, nothing was written
+#define MAX31856_WARM_MATCH			0	//Device already held the configuration, nothing was written
+#define MAX31856_WARM_REWRITTEN		1	//Registers that differed were written
+struct MAX31856_Record_Struct {
+	uint16_t Magic;			//MAX31856_RECORD_MAGIC
+	uint8_t Version;		//MAX31856_RECORD_VERSION
+	uint8_t Reserved;		//0, keeps the layout free of padding
+	uint8_t Image[12];		//Registers 0x00-0x0B, ONESHOT and FAULTCLR clear
+	uint16_t CRC;			//MAX31856CRC16() over everything before it
+};
+
+void MAX31856RecordMake(struct MAX31856_Record_Struct * R, struct MAX31856_REG_Struct * M = &MAX31856) {
+	R->Magic = MAX31856_RECORD_MAGIC;
+	R->Version = MAX31856_RECORD_VERSION;
+	R->Reserved = 0;
+	MAX31856PackConfig(M, &R->Image[0]);
+	R->Image[0] &= ~0x42;
+	R->CRC = MAX31856CRC16((const uint8_t *)R, sizeof(struct MAX31856_Record_Struct) - 2);
+} //===============================================================================================
+
+bool MAX31856RecordValid(const struct MAX31856_Record_Struct * R) {
+	if (R->Magic != MAX31856_RECORD_MAGIC || R->Version != MAX31856_RECORD_VERSION) return false;
+	return MAX31856CRC16((const uint8_t *)R, sizeof(struct MAX31856_Record_Struct) - 2) == R->CRC;
+} //===============================================================================================
+
+/*
+Bring one device in line with R.  Returns one of the MAX31856_WARM_* codes, either way D->M holds the device registers as read
+(and then written) and the shadow matches the chip so later MAX31856WriteRegisters(D) calls stay diff writes
+*/
+int8_t MAX31856WarmStart(struct MAX31856_Device_Struct * D, const struct MAX31856_Record_Struct * R) {
+	if (!MAX31856RecordValid(R)) return MAX31856_WARM_BAD_RECORD;
+	MAX31856ReadRegisters(D);
+
+	uint8_t Registers[16];
+	MAX31856PackRegisters(&D->M, &Registers[0]);
+	Registers[0] &= ~0x42;
+	memcpy(&D->Shadow[0], &Registers[0], sizeof(D->Shadow));
+	D->ShadowValid = true;
+
+	uint8_t Compare = sizeof(R->Image);
+	if (!(R->Image[0] & 0x08) && !(Registers[0] & 0x08)) Compare = 10; //Internal CJ sensor on both sides, CJTH/CJTL are measurements
+	if (memcmp(&Registers[0], &R->Image[0], Compare) == 0) return MAX31856_WARM_MATCH;
+
+	memcpy(&Registers[0], &R->Image[0], Compare);
+	MAX31856UnpackRegisters(&D->M, &Registers[0]);
+	MAX31856WriteRegisters(D);
+	return MAX31856_WARM_REWRITTEN;
+} //===============================================================================================
+
+/*
+MAX31856WarmStart() every device on the bus with the same record.  Returns how many devices had to be rewritten, or
+MAX31856_WARM_BAD_RECORD
+*/
+int8_t MAX31856BusWarmStart(struct MAX31856_Bus_Struct * B, const struct MAX31856_Record_Struct * R) {
+	if (!MAX31856RecordValid(R)) return MAX31856_WARM_BAD_RECORD;
+	int8_t Rewritten = 0;
+	for (uint8_t i = 0; i < B->NumDevices; i++) {
+		if (MAX31856WarmStart(&B->Devices[i], R) == MAX31856_WARM_REWRITTEN) Rewritten++;
+	}
+	return Rewritten;
+} //===============================================================================================
+
+/*
+Software filters on the LTC stream, so the chip can run at a low AVGSEL for a short Tconv and the noise is taken out here.
+All integer, in the same 1/128C units as MAX31856_Fixed_Struct.LTC, constant memory and a fixed amount of work per sample.
+Stages run in this order, each one off when its setting is 0:
+	Median		median of the last MedianN samples (3, 5 or 7), throws away single sample spikes without smearing them
+	EMA			exponential moving average, y += (x - y) / 2^EMAShift, time constant about 2^EMAShift samples.  EMAShift is
+				held to MAX31856_EMA_SHIFT_MAX, a 19 bit LTC shifted further would overflow the int32_t accumulator
+	Kalman		scalar random walk model.  KalmanQ is how far the temperature is expected to move per sample and KalmanR the
+				measurement noise, both as variances in (1/128C)^2.  The gain settles near EMA smoothing for the given noise but
+				a jump bigger than 3 sigma opens it back up, so steps come through far faster than through an EMA
+See extras/host/MAX31856FilterBench.cpp for noise and step latency of each stage against AVGSEL.
+Typical Use:
+	MAX31856_Filter_Struct Filter;
+
+	Setup {
+		MAX31856FilterBegin(&Filter, 3, 0, 4, 400);	//Median of 3 then Kalman for ~0.15C of noise, AVGSEL = 0
+	}
+	Loop() {
+		if (MAX31856DataReady(&TC)) {
+			MAX31856ReadTemperature(&TC);
+			double C = MAX31856LTCToDouble(MAX31856FilterUpdate(&Filter, MAX31856DecodeLTC(&TC.M.REG)));
+		}
+	}
+*/
+#ifndef MAX31856_MEDIAN_MAX
+#define MAX31856_MEDIAN_MAX		7
+#endif
+#define MAX31856_KALMAN_SHIFT	15		//Kalman gain is Q15
+#define MAX31856_EMA_SHIFT_MAX	12		//LTC is within +-2^18, so LTC << 12 plus one more LTC still fits an int32_t
+struct MAX31856_Filter_Struct {
+	uint8_t MedianN;					//0 or 1 for no median, otherwise odd and up to MAX31856_MEDIAN_MAX
+	uint8_t EMAShift;					//0 for no EMA
+	uint16_t KalmanQ;					//0 for no Kalman
+	uint16_t KalmanR;
+	bool Valid;							//False until the first sample, which every stage starts from
+	uint8_t MedianIndex;				//Next slot in Median[]
+	int32_t Median[MAX31856_MEDIAN_MAX];
+	int32_t EMA;						//Average << EMAShift, keeps the fraction between samples
+	int32_t KalmanX;					//Estimate
+	uint32_t KalmanP;					//Estimate variance, (1/128C)^2
+};
+
+void MAX31856FilterBegin(struct MAX31856_Filter_Struct * F, uint8_t MedianN, uint8_t EMAShift = 0, uint16_t KalmanQ = 0, uint16_t KalmanR = 0) {
+	memset((void *)F, 0, sizeof(struct MAX31856_Filter_Struct));
+	if (MedianN > MAX31856_MEDIAN_MAX) MedianN = MAX31856_MEDIAN_MAX;
+	if (MedianN && !(MedianN & 1)) MedianN--;
+	F->MedianN = MedianN;
+	if (EMAShift > MAX31856_EMA_SHIFT_MAX) EMAShift = MAX31856_EMA_SHIFT_MAX;
+	F->EMAShift = EMAShift;
+	F->KalmanQ = KalmanQ;
+	F->KalmanR = KalmanR;
+} //===============================================================================================
+
+/*
+Start again from the next sample, e.g. after an open thermocouple fault
+*/
+void MAX31856FilterReset(struct MAX31856_Filter_Struct * F) {
+	F->Valid = false;
+} //===============================================================================================
+
+int32_t MAX31856FilterMedian(struct MAX31856_Filter_Struct * F, int32_t LTC) {
+	F->Median[F->MedianIndex] = LTC;
+	if (++F->MedianIndex >= F->MedianN) F->MedianIndex = 0;
+	int32_t Sorted[MAX31856_MEDIAN_MAX];
+	for (uint8_t i = 0; i < F->MedianN; i++) { //Insertion sort, at most 7 entries
+		int32_t v = F->Median[i];
+		int8_t j = i - 1;
+		while (j >= 0 && Sorted[j] > v) { Sorted[j + 1] = Sorted[j]; j--; }
+		Sorted[j + 1] = v;
+	}
+	return Sorted[F->MedianN >> 1];
+} //===============================================================================================
+
+int32_t MAX31856FilterKalman(struct MAX31856_Filter_Struct * F, int32_t LTC) {
+	int32_t Innovation = LTC - F->KalmanX;
+	uint32_t Noise = F->KalmanP + F->KalmanQ + F->KalmanR;
+	if (Innovation > 32767 || Innovation < -32767) { //Over 256C away, nothing to smooth
+		F->KalmanX = LTC;
+		F->KalmanP = F->KalmanR;
+		return LTC;
+	}
+	uint32_t P = F->KalmanP + F->KalmanQ;
+	uint32_t Square = uint32_t(Innovation * Innovation);
+	if (Square > 9 * Noise) P += Square; //Outside 3 sigma, a real change rather than noise
+	if (P > 0xFFFF) P = 0xFFFF;
+	uint32_t K = (P << MAX31856_KALMAN_SHIFT) / (P + F->KalmanR);
+	F->KalmanX += (Innovation * int32_t(K) + (1L << (MAX31856_KALMAN_SHIFT - 1))) >> MAX31856_KALMAN_SHIFT;
+	F->KalmanP = (P * ((1UL << MAX31856_KALMAN_SHIFT) - K)) >> MAX31856_KALMAN_SHIFT;
+	return F->KalmanX;
+} //===============================================================================================
+
+/*
+Run one LTC sample through the enabled stages and return the filtered value, also in 1/128C
+*/
+int32_t MAX31856FilterUpdate(struct MAX31856_Filter_Struct * F, int32_t LTC) {
+	if (!F->Valid) {
+		for (uint8_t i = 0; i < MAX31856_MEDIAN_MAX; i++) F->Median[i] = LTC;
+		F->MedianIndex = 0;
+		F->EMA = LTC * (1L << F->EMAShift);
+		F->KalmanX = LTC;
+		F->KalmanP = F->KalmanR;
+		F->Valid = true;
+		return LTC;
+	}
+	if (F->MedianN > 1) LTC = MAX31856FilterMedian(F, LTC);
+	if (F->EMAShift) {
+		F->EMA += LTC - (F->EMA >> F->EMAShift);
+		LTC = (F->EMA + (1L << (F->EMAShift - 1))) >> F->EMAShift;
+	}
+	if (F->KalmanQ) LTC = MAX31856FilterKalman(F, LTC);
+	return LTC;
+} //===============================================================================================
+
+/*
+Adaptive averaging.  Picks CR1.AVGSEL at run time from the noise and slope of the samples, the fewest averaged samples that
+still meet NoiseTarget so the sample rate stays as high as possible, and MinAVGSEL at once while the temperature ramps faster
+than RampLimit.  The noise is taken from sample to sample differences so a steady ramp does not read as noise, and is assumed
+to drop by sqrt(2) per AVGSEL step.  A noise driven change needs the noise to be Hysteresis beyond the target and moves one step per
+Window samples, so it does not hunt.
+A change is a 2 byte write of CR1 alone.  The conversion running at the time of the write finishes with a mix of the old and
+new setting, so MAX31856AutoAverageUpdate() returns false for it and the caller should drop that sample.
+The notch (CR0.Hz50_60) has to match the local mains and is left alone.
+Typical Use:
+	MAX31856_AutoAverage_Struct Auto;
+
+	Setup {
+		MAX31856AutoAverageBegin(&Auto, &TC, 0.05, 2.0);	//0.05C noise, fastest sampling above 2C/s
+	}
+	Loop() {
+		if (MAX31856DataReady(&TC)) {
+			MAX31856ReadTemperature(&TC);
+			if (MAX31856AutoAverageUpdate(&Auto)) {
+				MAX31856Calculate(&TC.M);
+				...
+			}
+		}
+	}
+*/
+#ifndef MAX31856_AUTO_AVERAGE_WINDOW
+#define MAX31856_AUTO_AVERAGE_WINDOW	16	//Samples per decision
+#endif
+static_assert(MAX31856_AUTO_AVERAGE_WINDOW >= 2 && MAX31856_AUTO_AVERAGE_WINDOW < 255,
+	"MAX31856_AUTO_AVERAGE_WINDOW has to be 2 to 254, Count is a uint8_t that runs to one past it");
+static_assert(uint64_t(MAX31856_AUTO_AVERAGE_WINDOW) * 4095 * 4095 <= 0xFFFFFFFFull,
+	"MAX31856_AUTO_AVERAGE_WINDOW squared differences of up to 4095 have to fit SumSquares");
+struct MAX31856_AutoAverage_Struct {
+	struct MAX31856_Device_Struct * D;
+	float NoiseTarget;			//Standard deviation wanted, C
+	float RampLimit;			//C/s above which speed wins over noise, 0 to only look at noise
+	float Hysteresis;			//Fraction of NoiseTarget, 0.3 by default
+	uint8_t MinAVGSEL;			//Range the controller may use, 0-4
+	uint8_t MaxAVGSEL;
+	bool Discard;				//The next sample is the transition sample
+	bool Ramping;				//Last decision saw a ramp faster than RampLimit
+	uint8_t Count;				//Samples in the current window
+	int32_t Last;				//Previous LTC
+	uint32_t FirstMicros;		//When the first sample of the window was read
+	int32_t SumDelta;			//Sum of LTC differences over the window, 1/128C
+	uint32_t SumSquares;		//Sum of their squares
+	float Noise;				//Last measured noise, C
+	float Slope;				//Last measured rate of change, C/s
+	uint32_t Changes;			//AVGSEL writes made
+};
+
+void MAX31856AutoAverageBegin(struct MAX31856_AutoAverage_Struct * A, struct MAX31856_Device_Struct * D, float NoiseTarget, float RampLimit = 0) {
+	memset((void *)A, 0, sizeof(struct MAX31856_AutoAverage_Struct));
+	A->D = D;
+	A->NoiseTarget = NoiseTarget;
+	A->RampLimit = RampLimit;
+	A->Hysteresis = 0.3;
+	A->MaxAVGSEL = 4;
+} //===============================================================================================
+
+/*
+Write AVGSEL to CR1 on its own and start a new window
+*/
+void MAX31856AutoAverageSet(struct MAX31856_AutoAverage_Struct * A, uint8_t AVGSEL) {
+	struct MAX31856_Device_Struct * D = A->D;
+	D->M.REG.CR1.AVGSEL = AVGSEL;
+	uint8_t CR1 = D->M.REG.CR1.WORD;
+	MAX31856InstrumentBegin(D);
+	MAX31856WriteRange(D->CSPin, 0x01, &CR1, 1);
+	MAX31856InstrumentEnd(D, true);
+	D->Shadow[1] = CR1;
+	A->Discard = true;
+	A->Count = 0;
+	A->Changes++;
+} //===============================================================================================
+
+/*
+Call after every read of A->D.  Returns false if the sample just read straddled an AVGSEL change and should be dropped
+*/
+bool MAX31856AutoAverageUpdate(struct MAX31856_AutoAverage_Struct * A) {
+	struct MAX31856_Device_Struct * D = A->D;
+	int32_t LTC = MAX31856DecodeLTC(&D->M.REG);
+	if (A->Discard) {
+		A->Discard = false;
+		return false;
+	}
+	if (A->Count++ == 0) { //First sample of a window only sets the starting point
+		A->Last = LTC;
+		A->FirstMicros = D->LastReadMicros;
+		A->SumDelta = 0;
+		A->SumSquares = 0;
+		return true;
+	}
+	int32_t Delta = LTC - A->Last;
+	A->Last = LTC;
+	if (Delta > 4095) Delta = 4095; //32C in one sample is a ramp whatever the noise, keeps the squares in range
+	if (Delta < -4095) Delta = -4095;
+	A->SumDelta += Delta;
+	A->SumSquares += uint32_t(Delta * Delta);
+	if (A->Count <= MAX31856_AUTO_AVERAGE_WINDOW) return true;
+
+	float n = float(A->Count - 1);
+	float Mean = float(A->SumDelta) / n;
+	float Variance = float(A->SumSquares) / n - Mean * Mean;
+	if (Variance < 0) Variance = 0;
+	A->Noise = sqrt(Variance * 0.5) * 0.0078125; //A difference carries the noise of two samples
+	uint32_t Span = D->LastReadMicros - A->FirstMicros; //From the read times, so skipped conversions and a slow loop do not matter
+	A->Slope = Span ? float(A->SumDelta) * 0.0078125 * 1000000.0 / float(Span) : 0.0;
+	A->Count = 0;
+
+	uint8_t AVGSEL = D->M.REG.CR1.AVGSEL;
+	if (AVGSEL > A->MaxAVGSEL) AVGSEL = A->MaxAVGSEL;
+	if (AVGSEL < A->MinAVGSEL) AVGSEL = A->MinAVGSEL;
+	float Speed = fabs(A->Slope);
+	if (A->RampLimit > 0 && (Speed > A->RampLimit || (A->Ramping && Speed > A->RampLimit * 0.5))) {
+		A->Ramping = true;
+		AVGSEL = A->MinAVGSEL; //Straight there, stepping down would spend the start of the ramp on slow conversions
+	}
+	else {
+		A->Ramping = false;
+		if (A->Noise > A->NoiseTarget * (1.0 + A->Hysteresis) && AVGSEL < A->MaxAVGSEL) AVGSEL++;
+		else if (A->Noise * 1.41421356 < A->NoiseTarget * (1.0 - A->Hysteresis) && AVGSEL > A->MinAVGSEL) AVGSEL--;
+	}
+	if (AVGSEL != D->M.REG.CR1.AVGSEL) MAX31856AutoAverageSet(A, AVGSEL);
+	return true;
+} //===============================================================================================
+
+/*
+External cold junction.  With CR0.CJ set the MAX31856 stops measuring its own cold junction and compensates with whatever is in
+CJTH/CJTL, so one precision sensor on an isothermal block can serve every chip on it.  MAX31856ExternalCJ() switches the mode
+with a 2 byte CR0 write (MAX31856BusExternalCJ() broadcasts it to a whole bus), after which each update of the block
+temperature costs a 3 byte write at 0x8A per device, or a single 3 byte broadcast for a whole bus, instead of a 13 byte
+MAX31856WriteRegisters().
+The chip uses CJT when a conversion completes, so a write has to land between conversions to apply to a whole one:
+	Automatic conversion	MAX31856ExternalCJService() right after each read of a device writes the new value if that device
+							does not have it yet.  Set Bus.ExternalCJ and MAX31856BusService() does this itself.  The time is
+							measured from the DRDY edge of the conversion that was read (D->EdgeMicros, from the DRDY pin or
+							MAX31856DRDYInterrupt(), or the MAX31856PollService() estimate without DRDY).  If that edge is
+							not known, is more than MAX31856_EXTERNAL_CJ_WINDOW of Tconv ago, or DRDY is already back, the
+							write is put off to a later read rather than landing in the middle of a conversion.  So without
+							any DRDY or poll scheduler, automatic conversion never gets the push: use one shots instead
+	One shot on a bus		MAX31856ExternalCJBroadcast() just before MAX31856BusOneShot(), every device gets it before it starts
+The struct counts the writes and bytes so the bus cost can be checked with MAX31856PrintExternalCJ().
+Typical Use:
+	MAX31856_ExternalCJ_Struct BlockCJ = {};
+
+	Setup {
+		MAX31856BusExternalCJ(&Bus, true);
+		Bus.ExternalCJ = &BlockCJ;
+	}
+	Loop() {
+		if (BlockSensorReady()) MAX31856ExternalCJSet(&BlockCJ, BlockSensorC());
+		int8_t i = MAX31856BusService(&Bus); //Reads a device and pushes BlockCJ to it when it is due
+	}
+*/
+#define MAX31856_EXTERNAL_CJ_WINDOW	0.5	//Part of the typical Tconv after a DRDY edge in which a CJ write still counts as between conversions
+struct MAX31856_ExternalCJ_Struct {
+	int16_t CJT;			//Value to push, 1/256C with the 2 unused low bits clear
+	uint32_t Updates;		//Values set with MAX31856ExternalCJSet()
+	uint32_t Writes;		//SPI transactions used to push them
+	uint32_t Bytes;			//SPI bytes used to push them
+	uint32_t Deferred;		//Pushes put off because the conversion edge was unknown or too long ago
+};
+
+/*
+Temperature in C as the CJTH/CJTL register value, 1/64C resolution in the upper 14 bits
+*/
+int16_t MAX31856CJTFromDouble(double Temperature) {
+	double Value = floor(Temperature * 64.0 + 0.5) * 4.0;
+	if (Value > 32764.0) Value = 32764.0;
+	if (Value < -32768.0) Value = -32768.0;
+	return int16_t(Value);
+} //===============================================================================================
+
+/*
+Turn the internal cold junction sensor off (Enable) or back on with a CR0 write on its own
+*/
+void MAX31856ExternalCJ(struct MAX31856_Device_Struct * D, bool Enable) {
+	D->M.REG.CR0.CJ = Enable;
+	uint8_t CR0 = D->M.REG.CR0.WORD & ~0x42; //Neither a one shot nor a fault clear
+	MAX31856InstrumentBegin(D);
+	MAX31856WriteRange(D->CSPin, 0x00, &CR0, 1);
+	MAX31856InstrumentEnd(D, true);
+	D->Shadow[0] = CR0;
+} //===============================================================================================
+
+/*
+MAX31856ExternalCJ() for every device on the bus, one 2 byte broadcast if they all share the same CR0
+*/
+void MAX31856BusExternalCJ(struct MAX31856_Bus_Struct * B, bool Enable) {
+	if (B->NumDevices == 0) return;
+	bool Broadcast = true;
+	for (uint8_t i = 0; i < B->NumDevices; i++) {
+		B->Devices[i].M.REG.CR0.CJ = Enable;
+		if (B->Devices[i].CSPin == MAX31856_NO_PIN || B->Devices[i].M.REG.CR0.WORD != B->Devices[0].M.REG.CR0.WORD) Broadcast = false;
+	}
+
+	if (Broadcast) {
+		uint8_t BufferOut[2] = { 0x80, uint8_t(B->Devices[0].M.REG.CR0.WORD & ~0x42) };
+		MAX31856BusBroadcast(B, &BufferOut[0], sizeof(BufferOut));
+		for (uint8_t i = 0; i < B->NumDevices; i++) B->Devices[i].Shadow[0] = BufferOut[1];
+	}
+	else {
+		for (uint8_t i = 0; i < B->NumDevices; i++) MAX31856ExternalCJ(&B->Devices[i], Enable);
+	}
+} //===============================================================================================
+
+void MAX31856ExternalCJSet(struct MAX31856_ExternalCJ_Struct * X, double Temperature) {
+	X->CJT = MAX31856CJTFromDouble(Temperature);
+	X->Updates++;
+} //===============================================================================================
+
+/*
+Write CJT to one device now, 3 bytes
+*/
+void MAX31856WriteCJ(struct MAX31856_Device_Struct * D, int16_t CJT) {
+	uint8_t Data[2] = { uint8_t(uint16_t(CJT) >> 8), uint8_t(CJT) };
+	MAX31856InstrumentBegin(D);
+	MAX31856WriteRange(D->CSPin, 0x0A, &Data[0], 2);
+	MAX31856InstrumentEnd(D, true);
+	D->M.REG.CJT.CJT = CJT;
+	D->Shadow[10] = Data[0];
+	D->Shadow[11] = Data[1];
+} //===============================================================================================
+
+/*
+Call right after a read of D.  Pushes the current value if D does not hold it yet, returns true if it wrote.  In automatic
+conversion mode the push waits for a read whose conversion edge is known and recent enough, see D->EdgeMicros
+*/
+bool MAX31856ExternalCJService(struct MAX31856_ExternalCJ_Struct * X, struct MAX31856_Device_Struct * D) {
+	if (D->ShadowValid && D->Shadow[10] == uint8_t(uint16_t(X->CJT) >> 8) && D->Shadow[11] == uint8_t(X->CJT)) return false;
+	if (D->M.REG.CR0.CMODE) {
+		float Tconv, TconvMax;
+		MAX31856ConversionTime(&Tconv, &TconvMax, &D->M);
+		uint32_t Elapsed = micros() - D->EdgeMicros;
+		if (D->EdgeMicros == 0 || MAX31856DataReady(D) || Elapsed > uint32_t(Tconv * 1000.0 * MAX31856_EXTERNAL_CJ_WINDOW)) {
+			X->Deferred++;
+			return false;
+		}
+	}
+	MAX31856WriteCJ(D, X->CJT);
+	X->Writes++;
+	X->Bytes += 3;
+	return true;
+} //===============================================================================================
+
+/*
+Push the current value to every device on the bus in one 3 byte transaction
+*/
+void MAX31856ExternalCJBroadcast(struct MAX31856_ExternalCJ_Struct * X, struct MAX31856_Bus_Struct * B) {
+	uint8_t BufferOut[3] = { 0x8A, uint8_t(uint16_t(X->CJT) >> 8), uint8_t(X->CJT) };
+	MAX31856BusBroadcast(B, &BufferOut[0], sizeof(BufferOut));
+	for (uint8_t i = 0; i < B->NumDevices; i++) {
+		struct MAX31856_Device_Struct * D = &B->Devices[i];
+		D->M.REG.CJT.CJT = X->CJT;
+		D->Shadow[10] = BufferOut[1];
+		D->Shadow[11] = BufferOut[2];
+	}
+	X->Writes++;
+	X->Bytes += sizeof(BufferOut);
+} //===============================================================================================
+
+/*
+e.g. "External CJ: 25.125C, 40 updates, 640 writes, 1920 bytes (48.0 bytes per update), 3 deferred"
+*/
+void MAX31856PrintExternalCJ(Print &p, struct MAX31856_ExternalCJ_Struct * X) {
+	p.print(F("External CJ: ")); MAX31856PrintFloat(p, MAX31856CJTToDouble(X->CJT), 3); p.print(F("C, "));
+	p.print((unsigned long)X->Updates); p.print(F(" updates, "));
+	p.print((unsigned long)X->Writes); p.print(F(" writes, "));
+	p.print((unsigned long)X->Bytes); p.print(F(" bytes"));
+	if (X->Updates) {
+		p.print(F(" (")); MAX31856PrintFloat(p, double(X->Bytes) / double(X->Updates), 1); p.print(F(" bytes per update)"));
+	}
+	if (X->Deferred) {
+		p.print(F(", ")); p.print((unsigned long)X->Deferred); p.print(F(" deferred"));
+	}
+	p.print(F("\r\n"));
 } //===============================================================================================
@@ -0,0 +1,257 @@
+/*
+Command line batch decoder for captured MAX31856ReadRegisters() frames
+GitHub.com/TerryJMyers
+
+Memory maps the capture and decodes it in chunks through MAX31856BatchDecode(), so multi GB logs go through at memory speed
+without being loaded.  Output is columnar: one raw little endian file per value, ready for numpy.fromfile() and friends.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -o MAX31856BatchDecode extras/batchdecode/MAX31856BatchDecode.cpp
+
+Usage:
+	MAX31856BatchDecode [options] capture.bin
+		-o PREFIX		write PREFIX.ltc.i32 (1/128C), PREFIX.cjt.i16 (1/256C) and PREFIX.sr.u8
+		--celsius		also write PREFIX.ltc.f32 and PREFIX.cjt.f32 in C
+		--csv			print frame,LTC C,CJT C,SR to stdout
+		--stride N		bytes from the start of one frame to the next (default 17)
+		--skip N		bytes of file header before the first frame
+		--kernel K		scalar, ssse3 or avx2 instead of the fastest the CPU supports
+	MAX31856BatchDecode --bench [capture.bin | N]
+		times every kernel against a naive MAX31856UnpackRegisters() + MAX31856Calculate() loop, on the capture or on N synthetic
+		frames (default 10000000), and checks that every kernel gives the same columns
+*/
+#include "../host/MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856BatchDecode.h"
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <vector>
+
+#define MAX31856_BATCH_CHUNK	(1 << 20)	//Frames decoded per pass, keeps the column buffers in cache sized pieces
+
+typedef void (*MAX31856BatchKernel_t)(const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C);
+
+/*
+The per frame path the batch kernels replace
+*/
+void MAX31856BatchDecodeNaive(const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C) {
+	struct MAX31856_REG_Struct M;
+	for (size_t i = 0; i < Count; i++) {
+		MAX31856UnpackRegisters(&M, Frames + i * Stride + 1);
+		MAX31856Calculate(&M);
+		C->LTC[i] = int32_t(lround(M.LTCT * 128.0));
+		C->CJT[i] = int16_t(lround(M.CJT * 256.0));
+		C->SR[i] = M.REG.SR.WORD;
+	}
+} //===============================================================================================
+
+MAX31856BatchKernel_t MAX31856BatchKernelByName(const char * Name) {
+	if (strcmp(Name, "scalar") == 0) return MAX31856BatchDecodeScalar;
+#ifdef MAX31856_BATCH_X86
+	if (strcmp(Name, "ssse3") == 0 && __builtin_cpu_supports("ssse3")) return MAX31856BatchDecodeSSSE3;
+	if (strcmp(Name, "avx2") == 0 && __builtin_cpu_supports("avx2")) return MAX31856BatchDecodeAVX2;
+#endif
+	return NULL;
+} //===============================================================================================
+
+double MAX31856BatchSeconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+} //===============================================================================================
+
+FILE * MAX31856BatchOpen(const char * Prefix, const char * Suffix) {
+	std::string Name = std::string(Prefix) + Suffix;
+	FILE * f = fopen(Name.c_str(), "wb");
+	if (!f) fprintf(stderr, "Cannot create %s\n", Name.c_str());
+	return f;
+} //===============================================================================================
+
+/*
+Best of a few runs of one kernel over the whole capture, in frames per second
+*/
+double MAX31856BatchTime(MAX31856BatchKernel_t Kernel, const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C) {
+	double Best = 0.0;
+	for (uint8_t Run = 0; Run < 5; Run++) {
+		double Start = MAX31856BatchSeconds();
+		Kernel(Frames, Count, Stride, C);
+		double Elapsed = MAX31856BatchSeconds() - Start;
+		if (Best == 0.0 || Elapsed < Best) Best = Elapsed;
+	}
+	return double(Count) / Best;
+} //===============================================================================================
+
+int MAX31856BatchBench(const uint8_t * Frames, size_t Count, size_t Stride) {
+	std::vector<int32_t> LTC[2] = { std::vector<int32_t>(Count), std::vector<int32_t>(Count) };
+	std::vector<int16_t> CJT[2] = { std::vector<int16_t>(Count), std::vector<int16_t>(Count) };
+	std::vector<uint8_t> SR[2] = { std::vector<uint8_t>(Count), std::vector<uint8_t>(Count) };
+	struct MAX31856_Columns_Struct Reference = { LTC[0].data(), CJT[0].data(), SR[0].data() };
+	struct MAX31856_Columns_Struct Result = { LTC[1].data(), CJT[1].data(), SR[1].data() };
+
+	MAX31856BatchDecodeScalar(Frames, Count, Stride, &Reference);
+	double Naive = MAX31856BatchTime(MAX31856BatchDecodeNaive, Frames, Count, Stride, &Result);
+	printf("%-8s %12.0f frames/s\n", "naive", Naive);
+	const char * Names[] = { "scalar", "ssse3", "avx2" };
+	int Status = 0;
+	for (uint8_t k = 0; k < 3; k++) {
+		MAX31856BatchKernel_t Kernel = MAX31856BatchKernelByName(Names[k]);
+		if (!Kernel) {
+			printf("%-8s not supported on this CPU\n", Names[k]);
+			continue;
+		}
+		memset(Result.LTC, 0, Count * sizeof(int32_t));
+		double Rate = MAX31856BatchTime(Kernel, Frames, Count, Stride, &Result);
+		bool Same = memcmp(Result.LTC, Reference.LTC, Count * sizeof(int32_t)) == 0 && memcmp(Result.CJT, Reference.CJT, Count * sizeof(int16_t)) == 0
+			&& memcmp(Result.SR, Reference.SR, Count) == 0;
+		printf("%-8s %12.0f frames/s %6.1fx naive %s\n", Names[k], Rate, Rate / Naive, Same ? "" : "MISMATCH");
+		if (!Same) Status = 1;
+	}
+	return Status;
+} //===============================================================================================
+
+int main(int argc, char ** argv) {
+	const char * Input = NULL;
+	const char * Prefix = NULL;
+	const char * KernelName = NULL;
+	bool Celsius = false;
+	bool CSV = false;
+	bool Bench = false;
+	size_t Stride = MAX31856_BATCH_FRAME_LEN;
+	size_t Skip = 0;
+	for (int a = 1; a < argc; a++) {
+		if (strcmp(argv[a], "-o") == 0 && a + 1 < argc) Prefix = argv[++a];
+		else if (strcmp(argv[a], "--celsius") == 0) Celsius = true;
+		else if (strcmp(argv[a], "--csv") == 0) CSV = true;
+		else if (strcmp(argv[a], "--stride") == 0 && a + 1 < argc) Stride = strtoul(argv[++a], NULL, 0);
+		else if (strcmp(argv[a], "--skip") == 0 && a + 1 < argc) Skip = strtoul(argv[++a], NULL, 0);
+		else if (strcmp(argv[a], "--kernel") == 0 && a + 1 < argc) KernelName = argv[++a];
+		else if (strcmp(argv[a], "--bench") == 0) Bench = true;
+		else if (argv[a][0] != '-' && !Input) Input = argv[a];
+		else {
+			fprintf(stderr, "Unknown option %s\n", argv[a]);
+			return 2;
+		}
+	}
+	if (Stride < MAX31856_BATCH_FRAME_LEN) {
+		fprintf(stderr, "--stride has to be at least %d\n", MAX31856_BATCH_FRAME_LEN);
+		return 2;
+	}
+	MAX31856BatchKernel_t Kernel = MAX31856BatchDecode;
+	if (KernelName) {
+		Kernel = MAX31856BatchKernelByName(KernelName);
+		if (!Kernel) {
+			fprintf(stderr, "Kernel %s is not available on this CPU\n", KernelName);
+			return 2;
+		}
+	}
+
+	//Synthetic capture for --bench without a file: type K, a few hundred C, the odd fault
+	if (Bench && (!Input || strspn(Input, "0123456789") == strlen(Input))) {
+		size_t Count = Input ? strtoull(Input, NULL, 10) : 10000000;
+		std::vector<uint8_t> Frames(Count * MAX31856_BATCH_FRAME_LEN, 0);
+		uint32_t Seed = 0x31856;
+		for (size_t i = 0; i < Count; i++) {
+			uint8_t * p = &Frames[i * MAX31856_BATCH_FRAME_LEN];
+			Seed = Seed * 1664525u + 1013904223u;
+			int32_t LTC = int32_t(Seed >> 13) - (1 << 18);	//Full 19 bit range
+			int16_t CJT = int16_t((Seed & 0xFFFF) & 0xFFFC);
+			p[2] = 0x03;
+			p[MAX31856_BATCH_CJT] = uint8_t(uint16_t(CJT) >> 8);
+			p[MAX31856_BATCH_CJT + 1] = uint8_t(CJT);
+			p[MAX31856_BATCH_LTC] = uint8_t(LTC >> 11);
+			p[MAX31856_BATCH_LTC + 1] = uint8_t(LTC >> 3);
+			p[MAX31856_BATCH_LTC + 2] = uint8_t(LTC << 5);
+			p[MAX31856_BATCH_LTC + 3] = ((Seed & 0x3FF) == 0) ? 0x01 : 0x00;
+		}
+		printf("%zu synthetic frames, dispatch picks %s\n", Count, MAX31856BatchKernel());
+		return MAX31856BatchBench(&Frames[0], Count, MAX31856_BATCH_FRAME_LEN);
+	}
+	if (!Input) {
+		fprintf(stderr, "Usage: %s [-o PREFIX] [--celsius] [--csv] [--stride N] [--skip N] [--kernel K] capture.bin\n"
+			"       %s --bench [capture.bin | N]\n", argv[0], argv[0]);
+		return 2;
+	}
+
+	int fd = open(Input, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		fprintf(stderr, "Cannot open %s\n", Input);
+		return 1;
+	}
+	size_t Size = size_t(st.st_size);
+	size_t Count = (Size > Skip) ? (Size - Skip) / Stride : 0;
+	if (Count == 0) {
+		fprintf(stderr, "%s holds no complete frames\n", Input);
+		return 1;
+	}
+	if ((Size - Skip) % Stride != 0) fprintf(stderr, "Ignoring %zu trailing bytes\n", (Size - Skip) % Stride);
+	const uint8_t * Map = (const uint8_t *)mmap(NULL, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (Map == MAP_FAILED) {
+		fprintf(stderr, "Cannot map %s\n", Input);
+		return 1;
+	}
+	madvise((void *)Map, Size, MADV_SEQUENTIAL);
+	const uint8_t * Frames = Map + Skip;
+	if (Bench) return MAX31856BatchBench(Frames, Count, Stride);
+
+	FILE * Out[5] = { NULL, NULL, NULL, NULL, NULL };
+	if (Prefix) {
+		Out[0] = MAX31856BatchOpen(Prefix, ".ltc.i32");
+		Out[1] = MAX31856BatchOpen(Prefix, ".cjt.i16");
+		Out[2] = MAX31856BatchOpen(Prefix, ".sr.u8");
+		if (Celsius) {
+			Out[3] = MAX31856BatchOpen(Prefix, ".ltc.f32");
+			Out[4] = MAX31856BatchOpen(Prefix, ".cjt.f32");
+		}
+		for (uint8_t f = 0; f < (Celsius ? 5 : 3); f++) if (!Out[f]) return 1;
+	}
+
+	std::vector<int32_t> LTC(MAX31856_BATCH_CHUNK);
+	std::vector<int16_t> CJT(MAX31856_BATCH_CHUNK);
+	std::vector<uint8_t> SR(MAX31856_BATCH_CHUNK);
+	std::vector<float> LTCC(Celsius ? MAX31856_BATCH_CHUNK : 0);
+	std::vector<float> CJTC(Celsius ? MAX31856_BATCH_CHUNK : 0);
+	struct MAX31856_Columns_Struct C = { LTC.data(), CJT.data(), SR.data() };
+	int32_t Min = INT32_MAX;
+	int32_t Max = INT32_MIN;
+	size_t Faults = 0;
+	double DecodeSeconds = 0.0;
+	for (size_t First = 0; First < Count; First += MAX31856_BATCH_CHUNK) {
+		size_t n = Count - First;
+		if (n > MAX31856_BATCH_CHUNK) n = MAX31856_BATCH_CHUNK;
+		double Start = MAX31856BatchSeconds();
+		Kernel(Frames + First * Stride, n, Stride, &C);
+		DecodeSeconds += MAX31856BatchSeconds() - Start;
+		for (size_t i = 0; i < n; i++) {
+			if (LTC[i] < Min) Min = LTC[i];
+			if (LTC[i] > Max) Max = LTC[i];
+			if (SR[i]) Faults++;
+		}
+		if (Prefix) {
+			fwrite(LTC.data(), sizeof(int32_t), n, Out[0]);
+			fwrite(CJT.data(), sizeof(int16_t), n, Out[1]);
+			fwrite(SR.data(), 1, n, Out[2]);
+			if (Celsius) {
+				for (size_t i = 0; i < n; i++) {
+					LTCC[i] = float(LTC[i]) * 0.0078125f;
+					CJTC[i] = float(CJT[i]) * 0.00390625f;
+				}
+				fwrite(LTCC.data(), sizeof(float), n, Out[3]);
+				fwrite(CJTC.data(), sizeof(float), n, Out[4]);
+			}
+		}
+		if (CSV) {
+			for (size_t i = 0; i < n; i++) printf("%zu,%.4f,%.4f,%u\n", First + i, MAX31856LTCToDouble(LTC[i]), MAX31856CJTToDouble(CJT[i]), SR[i]);
+		}
+	}
+	for (uint8_t f = 0; f < 5; f++) if (Out[f]) fclose(Out[f]);
+	munmap((void *)Map, Size);
+	close(fd);
+
+	fprintf(stderr, "%zu frames, kernel %s, %.0f frames/s decode\n", Count, KernelName ? KernelName : MAX31856BatchKernel(), double(Count) / DecodeSeconds);
+	fprintf(stderr, "LTC %.4fC to %.4fC, %zu frames with a fault\n", MAX31856LTCToDouble(Min), MAX31856LTCToDouble(Max), Faults);
+	return 0;
+} //===============================================================================================
@@ -0,0 +1,145 @@
+/*
+Batch decode of captured MAX31856ReadRegisters() frames on a PC
+GitHub.com/TerryJMyers
+
+A capture is a file of back to back 17 byte BufferIn frames (BufferIn[0] is the dummy byte clocked in with the address,
+BufferIn[1..16] are registers 0x00-0x0F).  Only the measured values are pulled out, into separate columns:
+	LTC		int32_t		Linearized TC Temperature in 1/128C, LTCH/LTCM/LTCL as a 24 bit signed value >> 5
+	CJT		int16_t		Cold Junction Temperature in 1/256C, CJTH/CJTL
+	SR		uint8_t		Fault Status Register
+The same integer units as MAX31856_Fixed_Struct, so MAX31856LTCToDouble()/MAX31856CJTToDouble() turn them into C.
+
+Kernels:
+	MAX31856BatchDecodeScalar()		portable, any compiler
+	MAX31856BatchDecodeSSSE3()		4 frames per step, pshufb byte reorder
+	MAX31856BatchDecodeAVX2()		8 frames per step, gathered loads and vpshufb
+MAX31856BatchDecode() picks the widest one the CPU supports at runtime, so one binary runs everywhere.
+The SIMD kernels only exist on x86 with GCC or clang, everywhere else MAX31856BatchDecode() is the scalar kernel.
+
+Usage:
+	#include "extras/batchdecode/MAX31856BatchDecode.h"
+
+	MAX31856_Columns_Struct C = { LTC, CJT, SR };	//Caller owned arrays of Count entries
+	MAX31856BatchDecode(Frames, Count, MAX31856_BATCH_FRAME_LEN, &C);
+
+See MAX31856BatchDecode.cpp for the command line tool.
+*/
+#ifndef MAX31856_BATCH_DECODE_H
+#define MAX31856_BATCH_DECODE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MAX31856_BATCH_X86
+#include <immintrin.h>
+#endif
+
+#define MAX31856_BATCH_FRAME_LEN	17	//BufferIn of MAX31856ReadRegisters()
+#define MAX31856_BATCH_CJT			11	//Offset of CJTH in a frame, CJTL, LTCH, LTCM, LTCL and SR follow
+#define MAX31856_BATCH_LTC			13	//Offset of LTCH in a frame
+
+struct MAX31856_Columns_Struct {
+	int32_t * LTC;	//1/128C
+	int16_t * CJT;	//1/256C
+	uint8_t * SR;
+};
+
+/*
+Stride is the distance between frames, MAX31856_BATCH_FRAME_LEN for a plain capture or more if each frame carries extra bytes
+(a timestamp, ...) after the 17 byte BufferIn
+*/
+void MAX31856BatchDecodeScalar(const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C) {
+	for (size_t i = 0; i < Count; i++) {
+		const uint8_t * p = Frames + i * Stride;
+		C->CJT[i] = int16_t(uint16_t(p[MAX31856_BATCH_CJT] << 8 | p[MAX31856_BATCH_CJT + 1]));
+		C->LTC[i] = int32_t(uint32_t(p[MAX31856_BATCH_LTC]) << 24 | uint32_t(p[MAX31856_BATCH_LTC + 1]) << 16 | uint32_t(p[MAX31856_BATCH_LTC + 2]) << 8) >> 13;
+		C->SR[i] = p[MAX31856_BATCH_LTC + 3];
+	}
+} //===============================================================================================
+
+#ifdef MAX31856_BATCH_X86
+static inline int32_t MAX31856BatchLoad32(const uint8_t * p) {
+	int32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+} //===============================================================================================
+
+/*
+Each 32 bit lane holds 4 bytes of one frame.  Loaded from LTCH the lane is H M L SR (low byte first), reordered to 0 L M H it is the
+LTC code << 13 so an arithmetic shift leaves it sign extended.  Loaded from CJTH the lane is H L x x, reordered to 0 0 L H and shifted
+down 16 it is the sign extended CJT.
+*/
+__attribute__((target("ssse3")))
+void MAX31856BatchDecodeSSSE3(const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C) {
+	const __m128i LTCOrder = _mm_setr_epi8(-1, 2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12);
+	const __m128i CJTOrder = _mm_setr_epi8(-1, -1, 1, 0, -1, -1, 5, 4, -1, -1, 9, 8, -1, -1, 13, 12);
+	const __m128i SROrder = _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	size_t i = 0;
+	for (; i + 4 <= Count; i += 4) {
+		const uint8_t * p = Frames + i * Stride;
+		__m128i A = _mm_setr_epi32(MAX31856BatchLoad32(p + MAX31856_BATCH_LTC), MAX31856BatchLoad32(p + Stride + MAX31856_BATCH_LTC),
+			MAX31856BatchLoad32(p + 2 * Stride + MAX31856_BATCH_LTC), MAX31856BatchLoad32(p + 3 * Stride + MAX31856_BATCH_LTC));
+		__m128i B = _mm_setr_epi32(MAX31856BatchLoad32(p + MAX31856_BATCH_CJT), MAX31856BatchLoad32(p + Stride + MAX31856_BATCH_CJT),
+			MAX31856BatchLoad32(p + 2 * Stride + MAX31856_BATCH_CJT), MAX31856BatchLoad32(p + 3 * Stride + MAX31856_BATCH_CJT));
+		__m128i LTC = _mm_srai_epi32(_mm_shuffle_epi8(A, LTCOrder), 13);
+		__m128i CJT = _mm_srai_epi32(_mm_shuffle_epi8(B, CJTOrder), 16);
+		_mm_storeu_si128((__m128i *)(C->LTC + i), LTC);
+		_mm_storel_epi64((__m128i *)(C->CJT + i), _mm_packs_epi32(CJT, CJT));
+		int32_t SR = _mm_cvtsi128_si32(_mm_shuffle_epi8(A, SROrder));
+		memcpy(C->SR + i, &SR, 4);
+	}
+	struct MAX31856_Columns_Struct Tail = { C->LTC + i, C->CJT + i, C->SR + i };
+	MAX31856BatchDecodeScalar(Frames + i * Stride, Count - i, Stride, &Tail);
+} //===============================================================================================
+
+__attribute__((target("avx2")))
+void MAX31856BatchDecodeAVX2(const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C) {
+	const __m256i LTCOrder = _mm256_setr_epi8(-1, 2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1, 2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12);
+	const __m256i CJTOrder = _mm256_setr_epi8(-1, -1, 1, 0, -1, -1, 5, 4, -1, -1, 9, 8, -1, -1, 13, 12, -1, -1, 1, 0, -1, -1, 5, 4, -1, -1, 9, 8, -1, -1, 13, 12);
+	const __m256i SROrder = _mm256_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+	const __m256i Index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(int32_t(Stride)));
+	size_t i = 0;
+	if (Stride <= 0x7FFFFFFF / 8) {
+		for (; i + 8 <= Count; i += 8) {
+			const uint8_t * p = Frames + i * Stride;
+			__m256i A = _mm256_i32gather_epi32((const int *)(p + MAX31856_BATCH_LTC), Index, 1);
+			__m256i B = _mm256_i32gather_epi32((const int *)(p + MAX31856_BATCH_CJT), Index, 1);
+			__m256i LTC = _mm256_srai_epi32(_mm256_shuffle_epi8(A, LTCOrder), 13);
+			__m256i CJT = _mm256_srai_epi32(_mm256_shuffle_epi8(B, CJTOrder), 16);
+			_mm256_storeu_si256((__m256i *)(C->LTC + i), LTC);
+			CJT = _mm256_permute4x64_epi64(_mm256_packs_epi32(CJT, CJT), 0x08); //Pack works per 128 bit lane, bring both halves together
+			_mm_storeu_si128((__m128i *)(C->CJT + i), _mm256_castsi256_si128(CJT));
+			__m256i SR = _mm256_shuffle_epi8(A, SROrder);
+			int32_t SRLow = _mm256_extract_epi32(SR, 0);
+			int32_t SRHigh = _mm256_extract_epi32(SR, 4);
+			memcpy(C->SR + i, &SRLow, 4);
+			memcpy(C->SR + i + 4, &SRHigh, 4);
+		}
+	}
+	struct MAX31856_Columns_Struct Tail = { C->LTC + i, C->CJT + i, C->SR + i };
+	MAX31856BatchDecodeScalar(Frames + i * Stride, Count - i, Stride, &Tail);
+} //===============================================================================================
+#endif
+
+/*
+Name of the kernel MAX31856BatchDecode() will use on this CPU
+*/
+const char * MAX31856BatchKernel() {
+#ifdef MAX31856_BATCH_X86
+	if (__builtin_cpu_supports("avx2")) return "avx2";
+	if (__builtin_cpu_supports("ssse3")) return "ssse3";
+#endif
+	return "scalar";
+} //===============================================================================================
+
+void MAX31856BatchDecode(const uint8_t * Frames, size_t Count, size_t Stride, struct MAX31856_Columns_Struct * C) {
+#ifdef MAX31856_BATCH_X86
+	if (__builtin_cpu_supports("avx2")) { MAX31856BatchDecodeAVX2(Frames, Count, Stride, C); return; }
+	if (__builtin_cpu_supports("ssse3")) { MAX31856BatchDecodeSSSE3(Frames, Count, Stride, C); return; }
+#endif
+	MAX31856BatchDecodeScalar(Frames, Count, Stride, C);
+} //===============================================================================================
+
+#endif
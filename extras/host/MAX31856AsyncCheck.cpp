@@ -0,0 +1,213 @@
+/*
+Async DRDY pipeline (MAX31856AsyncStart()/MAX31856AsyncService()) against the simulator, with the interrupts emulated
+GitHub.com/TerryJMyers
+
+Puts MAX31856_CHECK_DEVICES simulated MAX31856 with DRDY pins on one bus in automatic conversion, their oscillators a little
+apart so the DRDY edges drift through each other, and emulates the interrupt side on the host:
+	DRDY		a falling edge on a simulated DRDY pin runs the ISR, MAX31856AsyncStart(), as soon as interrupts are enabled
+				and no other ISR is running.  Edges are looked for on every main loop pass, on every pass through interrupts()
+				(MAX31856HostInterrupts) and at both ends of every blocking Transfer, so they also land while a blocking
+				write from the main loop holds the bus
+	DMA			with TransferAsync set the transfer is clocked into the simulator at the time a real one would end and its
+				Done is then called from the emulated interrupt, so DRDYs of other devices queue behind it and
+				MAX31856BusClaim() spins until it is done
+The main loop services every pipeline every ServiceMicros and rewrites every configuration (MAX31856WriteRegisters(), ForceFull)
+every MAX31856_CHECK_WRITE_MICROS.  Each device has its own hot junction ramping at MAX31856_CHECK_RAMP C/s, so a sample read
+from the wrong device, a torn one or one from an earlier conversion than its DRDY edge is out of the range the callback checks
+it against.  Prints per row:
+	Conv		conversions the devices made
+	Samples		samples decoded, the callback checked each of them
+	Dropped		DRDY edges that found both buffers of their pipeline still waiting on the main loop
+	Missed		conversions replaced in the device before they were read
+	Queued		DRDY edges that found the bus busy and went into the pending queue
+	Bad			samples outside the range of their conversion, or not newer than the one before from the same device
+	Lat us		worst DRDY to data in (MaxTransferLatencyMicros) over the devices
+and fails the row if any sample was bad, if Samples + Missed does not account for every conversion, if nothing ever queued,
+or, with the main loop keeping up, if anything was dropped or missed or the worst latency is over MAX31856_CHECK_MAX_LATENCY.
+A slow main loop has to drop, the row then checks the pipelines carry on afterwards.  Exits with 1 if any row failed.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856AsyncCheck extras/host/MAX31856AsyncCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856Sim.h"
+
+#define MAX31856_CHECK_DEVICES			4
+#define MAX31856_CHECK_DRDY_PIN			32			//DRDY pins follow the CS pins 0 to MAX31856_CHECK_DEVICES - 1
+#define MAX31856_CHECK_RUN_MICROS		20000000	//Simulated time per row
+#define MAX31856_CHECK_LOOP_MICROS		20			//Main loop pass
+#define MAX31856_CHECK_WRITE_MICROS		1000		//Blocking configuration writes from the main loop
+#define MAX31856_CHECK_SPIN_NANOS		200			//Simulated time one pass through interrupts() takes
+#define MAX31856_CHECK_RAMP				1.0			//Hot junction ramp, C/s, about 10 LTC counts per conversion
+#define MAX31856_CHECK_MAX_LATENCY		500
+
+MAX31856Sim_Struct MAX31856CheckSim[MAX31856_CHECK_DEVICES];
+MAX31856_Device_Struct MAX31856CheckTC[MAX31856_CHECK_DEVICES];
+MAX31856_Async_Struct MAX31856CheckAsync[MAX31856_CHECK_DEVICES];
+bool MAX31856CheckLevel[MAX31856_CHECK_DEVICES];		//DRDY level the emulated interrupt controller saw last
+int32_t MAX31856CheckLastLTC[MAX31856_CHECK_DEVICES];
+uint64_t MAX31856CheckStartNanos;
+bool MAX31856CheckInISR;
+uint32_t MAX31856CheckQueued, MAX31856CheckBad;
+
+//The one emulated DMA channel
+bool MAX31856CheckDMABusy;
+uint64_t MAX31856CheckDMADoneNanos;
+const uint8_t * MAX31856CheckDMAOut;
+uint8_t * MAX31856CheckDMAIn;
+uint16_t MAX31856CheckDMALength;
+void (*MAX31856CheckDMADone)(void * Context);
+void * MAX31856CheckDMAContext;
+
+/*
+Hot junction of device i at a time, C
+*/
+double MAX31856CheckTemperature(uint8_t i, uint64_t Nanos) {
+	return 100.0 + 50.0 * double(i) + MAX31856_CHECK_RAMP * double(Nanos - MAX31856CheckStartNanos) * 1.0E-9;
+} //===============================================================================================
+
+/*
+Bring the simulators up to now with their inputs where the ramps are
+*/
+void MAX31856CheckUpdate() {
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		MAX31856CheckSim[i].Temperature = MAX31856CheckTemperature(i, MAX31856HostNanos);
+		MAX31856SimUpdate(&MAX31856CheckSim[i]);
+	}
+} //===============================================================================================
+
+/*
+The emulated interrupt controller: finishes the DMA transfer once its time is up and runs the DRDY ISR of every falling edge
+*/
+void MAX31856CheckInterrupts() {
+	if (MAX31856CheckInISR || !MAX31856HostInterruptsEnabled) return;
+	MAX31856CheckInISR = true;
+	MAX31856HostNanos += MAX31856_CHECK_SPIN_NANOS;
+	MAX31856CheckUpdate();
+	if (MAX31856CheckDMABusy && MAX31856HostNanos >= MAX31856CheckDMADoneNanos) {
+		MAX31856CheckDMABusy = false;
+		MAX31856SimTransfer(MAX31856CheckDMAOut, MAX31856CheckDMAIn, MAX31856CheckDMALength);
+		MAX31856CheckDMADone(MAX31856CheckDMAContext);
+	}
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		bool Level = MAX31856CheckSim[i].DRDY;
+		if (MAX31856CheckLevel[i] && !Level) {
+			if (MAX31856AsyncActive != NULL || MAX31856BusBlocking) MAX31856CheckQueued++;
+			MAX31856AsyncStart(&MAX31856CheckAsync[i]);
+		}
+		MAX31856CheckLevel[i] = Level;
+	}
+	MAX31856CheckInISR = false;
+} //===============================================================================================
+
+/*
+Transport: the simulator, with interrupts able to come in during a blocking transfer, and a DMA channel
+*/
+void MAX31856CheckTransfer(const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length) {
+	MAX31856CheckInterrupts();
+	MAX31856SimTransfer(BufferOut, BufferIn, Length);
+	MAX31856CheckInterrupts();
+} //===============================================================================================
+void MAX31856CheckTransferAsync(const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length, void (*Done)(void * Context), void * Context) {
+	MAX31856CheckDMABusy = true;
+	MAX31856CheckDMADoneNanos = MAX31856HostNanos + MAX31856_SIM_TRANSACTION_NANOS + uint64_t(Length) * 8 * 1000000000ull / MAX31856_SIM_SPI_HZ;
+	MAX31856CheckDMAOut = BufferOut;
+	MAX31856CheckDMAIn = BufferIn;
+	MAX31856CheckDMALength = Length;
+	MAX31856CheckDMADone = Done;
+	MAX31856CheckDMAContext = Context;
+} //===============================================================================================
+MAX31856_Transport_Struct MAX31856CheckBlocking = { MAX31856SimTransportBegin, MAX31856SimTransportEnd, MAX31856SimSelect, MAX31856CheckTransfer, NULL };
+MAX31856_Transport_Struct MAX31856CheckDMA = { MAX31856SimTransportBegin, MAX31856SimTransportEnd, MAX31856SimSelect, MAX31856CheckTransfer, MAX31856CheckTransferAsync };
+
+/*
+Each sample has to come from a conversion of its own device that ended between its DRDY edge and the end of its read.  The
+edge is stamped when the ISR runs, which can be later than the end of the conversion by as long as interrupts were held
+off, a millisecond is plenty.  A sample read after a dropped DRDY is stamped with that edge and may be from a later
+conversion, which the range still covers
+*/
+void MAX31856CheckSample(struct MAX31856_Async_Struct * A, struct MAX31856_Fixed_Struct * T) {
+	uint8_t i = uint8_t(A - &MAX31856CheckAsync[0]);
+	uint64_t EdgeNanos = uint64_t(A->D->EdgeMicros) * 1000, ReadNanos = uint64_t(A->D->LastReadMicros) * 1000;
+	int32_t Lo = int32_t(floor(MAX31856CheckTemperature(i, EdgeNanos - 1000000) * 128.0)) - 1;
+	int32_t Hi = int32_t(ceil(MAX31856CheckTemperature(i, ReadNanos) * 128.0)) + 1;
+	if (T->LTC < Lo || T->LTC > Hi || T->LTC <= MAX31856CheckLastLTC[i]) MAX31856CheckBad++;
+	MAX31856CheckLastLTC[i] = T->LTC;
+} //===============================================================================================
+
+bool MAX31856CheckRun(const char * Name, bool DMA, uint32_t ServiceMicros) {
+	const double ClockScales[MAX31856_CHECK_DEVICES] = { 1.000, 1.003, 0.997, 1.006 };
+	MAX31856HostNanos += 1000000000ull; //Each row starts from its own point in time
+	MAX31856CheckStartNanos = MAX31856HostNanos;
+	MAX31856AsyncList = NULL;
+	MAX31856CheckDMABusy = false;
+	MAX31856CheckQueued = 0;
+	MAX31856CheckBad = 0;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		MAX31856SimBegin(&MAX31856CheckSim[i], i, MAX31856_CHECK_DRDY_PIN + i);
+		MAX31856CheckSim[i].ClockScale = ClockScales[i];
+	}
+	MAX31856SimAttach(&MAX31856CheckSim[0], MAX31856_CHECK_DEVICES);
+	MAX31856Transport = DMA ? &MAX31856CheckDMA : &MAX31856CheckBlocking;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		MAX31856Begin(&MAX31856CheckTC[i], i, MAX31856_CHECK_DRDY_PIN + i);
+		MAX31856CheckTC[i].M.REG.CR0.CMODE = true;
+		MAX31856CheckTC[i].M.REG.CR1.TCTYPE = 3;
+		MAX31856WriteRegisters(&MAX31856CheckTC[i]);
+		MAX31856AsyncBegin(&MAX31856CheckAsync[i], &MAX31856CheckTC[i], MAX31856CheckSample);
+		MAX31856CheckLevel[i] = HIGH;
+		MAX31856CheckLastLTC[i] = INT32_MIN;
+		MAX31856HostAdvanceMicros(17000); //Spread the conversions out
+	}
+	MAX31856HostInterrupts = MAX31856CheckInterrupts;
+
+	uint32_t StartMicros = micros(), ServiceAt = StartMicros, WriteAt = StartMicros;
+	while (micros() - StartMicros < MAX31856_CHECK_RUN_MICROS) {
+		MAX31856HostAdvanceMicros(MAX31856_CHECK_LOOP_MICROS);
+		MAX31856CheckInterrupts();
+		if (micros() - ServiceAt >= ServiceMicros) {
+			ServiceAt = micros();
+			for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+				while (MAX31856AsyncService(&MAX31856CheckAsync[i])) {}
+			}
+		}
+		if (micros() - WriteAt >= MAX31856_CHECK_WRITE_MICROS) {
+			WriteAt = micros();
+			for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) MAX31856WriteRegisters(&MAX31856CheckTC[i], true);
+		}
+	}
+	MAX31856HostInterrupts = NULL;
+	MAX31856CheckUpdate();
+
+	uint32_t Conversions = 0, Samples = 0, Dropped = 0, Missed = 0, Latency = 0;
+	bool Pass = MAX31856CheckBad == 0 && MAX31856CheckQueued != 0;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		struct MAX31856_Async_Struct * A = &MAX31856CheckAsync[i];
+		//At most two buffers waiting on the main loop and one conversion waiting on the bus are not yet counted
+		uint32_t Unaccounted = MAX31856CheckSim[i].Conversions - A->Samples - MAX31856CheckSim[i].Missed;
+		if (Unaccounted > 3) Pass = false;
+		Conversions += MAX31856CheckSim[i].Conversions;
+		Samples += A->Samples;
+		Dropped += A->Dropped;
+		Missed += MAX31856CheckSim[i].Missed;
+		if (A->MaxTransferLatencyMicros > Latency) Latency = A->MaxTransferLatencyMicros;
+	}
+	if (ServiceMicros <= MAX31856_CHECK_LOOP_MICROS) Pass = Pass && Dropped == 0 && Missed == 0 && Latency <= MAX31856_CHECK_MAX_LATENCY;
+	else Pass = Pass && Dropped != 0 && Samples >= MAX31856_CHECK_DEVICES * (MAX31856_CHECK_RUN_MICROS / ServiceMicros);
+	printf("%-24s %6lu %7lu %7lu %6lu %6lu %4lu %6lu %5s\n", Name, (unsigned long)Conversions, (unsigned long)Samples,
+		(unsigned long)Dropped, (unsigned long)Missed, (unsigned long)MAX31856CheckQueued, (unsigned long)MAX31856CheckBad,
+		(unsigned long)Latency, Pass ? "ok" : "FAIL");
+	return Pass;
+} //===============================================================================================
+
+int main() {
+	bool Pass = true;
+	printf("%-24s %6s %7s %7s %6s %6s %4s %6s\n", "Case", "Conv", "Samples", "Dropped", "Missed", "Queued", "Bad", "Lat us");
+	Pass &= MAX31856CheckRun("Transfer in ISR", false, 0);
+	Pass &= MAX31856CheckRun("TransferAsync", true, 0);
+	Pass &= MAX31856CheckRun("Transfer in ISR, slow", false, 250000);
+	Pass &= MAX31856CheckRun("TransferAsync, slow", true, 250000);
+	printf("\n%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================
@@ -0,0 +1,130 @@
+/*
+Channel rate of the MAX31856_Bus_Struct scheduler against the number of devices on the bus
+GitHub.com/TerryJMyers
+
+Puts 1 to 120 simulated MAX31856 in automatic conversion mode on one bus and services them from a main loop that spends
+LoopMicros on other work per pass, for each scheduling mode and read length, and prints:
+	Pass		1 for one MAX31856BusService() per pass, all for MAX31856BusServiceAll() draining every ready device
+	ch/s		MAX31856BusChannelsPerSecond(), device reads per second
+	Fresh/s		conversions that were read before the next one replaced them, per second for the whole bus
+	Conv/s		conversions the devices made per second, the most Fresh/s can be
+	Missed		conversions overwritten unread, percent of Conv/s
+	Gap ms		worst time a device waited between two reads (MaxIntervalMicros)
+	Bus			share of the time spent clocking SPI
+	Limit		what capped Fresh/s: conv when every conversion was read, loop when one read per pass could not keep up
+				with the conversions, bus when the SPI clock was busy more than 90% of the time
+Round robin reads a device every pass whether it has anything new or not, so its ch/s is high but many reads are repeats.
+DRDY priority only reads devices with a conversion waiting.  With one read per pass the channel rate can never pass the
+loop rate, so those rows go loop limited as soon as the devices convert faster than the loop turns.  Draining every ready
+device per pass takes that cap away and only the bus clock is left, the ceiling printed in the header.  Even 120 devices
+at AVGSEL 0 convert well under a tenth of that ceiling, so the drained rows stay conv limited.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856BusBench extras/host/MAX31856BusBench.cpp
+
+Usage:
+	MAX31856BusBench [LoopMicros] [AVGSEL]
+		LoopMicros is the time the rest of the main loop takes per pass, default 1000, 0 for a loop doing nothing else
+		AVGSEL sets CR1.AVGSEL on every device, default 0
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856Sim.h"
+
+#include <stdlib.h>
+
+#define MAX31856_BENCH_MAX_DEVICES	120
+#define MAX31856_BENCH_RUN_MICROS	4000000		//Simulated time per row
+#define MAX31856_BENCH_DRDY_PIN		128			//DRDY pins follow the CS pins 0 to MAX31856_BENCH_MAX_DEVICES - 1
+#define MAX31856_BENCH_IDLE_MICROS	10			//Time a LoopMicros 0 pass takes when nothing was read
+
+MAX31856Sim_Struct MAX31856BenchSims[MAX31856_BENCH_MAX_DEVICES];
+MAX31856_Device_Struct MAX31856BenchTCs[MAX31856_BENCH_MAX_DEVICES];
+
+const uint8_t MAX31856BenchCounts[] = { 1, 2, 4, 8, 16, 32, 64, 96, 120 };
+
+void MAX31856BenchRun(uint8_t NumDevices, uint8_t Mode, bool FastRead, bool Drain, uint32_t LoopMicros, uint8_t AVGSEL) {
+	for (uint8_t i = 0; i < NumDevices; i++) {
+		MAX31856SimBegin(&MAX31856BenchSims[i], i, MAX31856_BENCH_DRDY_PIN + i);
+		MAX31856BenchSims[i].Temperature = 100.0 + i;
+		MAX31856BenchSims[i].ClockScale = 1.0 + 0.002 * (i % 7); //Oscillator spread so the devices drift apart
+	}
+	MAX31856SimAttach(&MAX31856BenchSims[0], NumDevices);
+	for (uint8_t i = 0; i < NumDevices; i++) {
+		struct MAX31856_Device_Struct * D = &MAX31856BenchTCs[i];
+		MAX31856Begin(D, i, MAX31856_BENCH_DRDY_PIN + i);
+		D->M.REG.CR0.CMODE = true;
+		D->M.REG.CR1.TCTYPE = 3;
+		D->M.REG.CR1.AVGSEL = AVGSEL;
+		MAX31856WriteRegisters(D);
+		MAX31856HostAdvanceMicros(LoopMicros / 4 + 1); //Start the devices at different points of a conversion
+	}
+
+	struct MAX31856_Bus_Struct Bus;
+	MAX31856BusBegin(&Bus, &MAX31856BenchTCs[0], NumDevices, Mode);
+	Bus.FastRead = FastRead;
+	uint32_t Conversions = 0, Missed = 0, Fresh = 0; //Fresh counts conversions waiting at the start and takes off those waiting at the end
+	for (uint8_t i = 0; i < NumDevices; i++) {
+		MAX31856SimUpdate(&MAX31856BenchSims[i]);
+		Conversions -= MAX31856BenchSims[i].Conversions;
+		Missed -= MAX31856BenchSims[i].Missed;
+		if (MAX31856BenchSims[i].DRDY == LOW) Fresh++;
+	}
+	uint64_t StartNanos = MAX31856HostNanos;
+	uint64_t BusNanos = 0;
+	while (micros() - Bus.StartMicros < MAX31856_BENCH_RUN_MICROS) {
+		uint64_t Before = MAX31856HostNanos;
+		if (Drain) MAX31856BusServiceAll(&Bus);
+		else MAX31856BusService(&Bus);
+		BusNanos += MAX31856HostNanos - Before;
+		if (LoopMicros) MAX31856HostAdvanceMicros(LoopMicros);
+		else if (MAX31856HostNanos == Before) MAX31856HostAdvanceMicros(MAX31856_BENCH_IDLE_MICROS); //Nothing was read
+	}
+	MAX31856SimUpdateAll();
+	for (uint8_t i = 0; i < NumDevices; i++) {
+		Conversions += MAX31856BenchSims[i].Conversions;
+		Missed += MAX31856BenchSims[i].Missed;
+		if (MAX31856BenchSims[i].DRDY == LOW) Fresh--;
+	}
+	Fresh += Conversions - Missed;
+
+	double Seconds = double(MAX31856HostNanos - StartNanos) * 1.0E-9;
+	double MissedShare = Conversions ? 100.0 * double(Missed) / double(Conversions) : 0.0;
+	double BusShare = 100.0 * double(BusNanos) * 1.0E-9 / Seconds;
+	const char * Limit = "conv";
+	if (BusShare > 90.0) Limit = "bus";
+	else if (MissedShare > 1.0) Limit = Drain ? "bus" : "loop";
+	printf("%7u %-6s %5s %4s %9.0f %9.1f %9.1f %7.1f%% %8.1f %6.2f%% %5s\n", NumDevices, (Mode == MAX31856_BUS_ROUND_ROBIN) ? "RR" : "DRDY",
+		FastRead ? "7" : "17", Drain ? "all" : "1", MAX31856BusChannelsPerSecond(&Bus), double(Fresh) / Seconds,
+		double(Conversions) / Seconds, MissedShare, double(Bus.MaxIntervalMicros) / 1000.0, BusShare, Limit);
+} //===============================================================================================
+
+int main(int argc, char ** argv) {
+	uint32_t LoopMicros = (argc > 1) ? uint32_t(atol(argv[1])) : 1000;
+	uint8_t AVGSEL = (argc > 2) ? uint8_t(atoi(argv[2])) : 0;
+
+	struct MAX31856_REG_Struct M = {};
+	M.REG.CR0.CMODE = true;
+	M.REG.CR1.AVGSEL = AVGSEL;
+	float Tconv, TconvMax;
+	MAX31856ConversionTime(&Tconv, &TconvMax, &M);
+	printf("Main loop %luus per pass, AVGSEL %u, Tconv %.1fms, SPI %.1fMHz\n", (unsigned long)LoopMicros, AVGSEL, Tconv,
+		MAX31856_SIM_SPI_HZ / 1.0E6);
+	const uint8_t ReadBytes[2] = { 17, 7 };
+	for (uint8_t b = 0; b < sizeof(ReadBytes); b++) { //Back to back reads with no loop in between
+		double ReadNanos = double(ReadBytes[b]) * 8.0 * 1.0E9 / MAX31856_SIM_SPI_HZ + MAX31856_SIM_TRANSACTION_NANOS;
+		printf("Bus ceiling, %u byte reads: %.0f ch/s\n", ReadBytes[b], 1.0E9 / ReadNanos);
+	}
+	if (LoopMicros) printf("Loop ceiling, one read per pass: %.0f ch/s\n", 1.0E6 / double(LoopMicros));
+	printf("\n%7s %-6s %5s %4s %9s %9s %9s %8s %8s %7s %5s\n", "Devices", "Mode", "Bytes", "Pass", "ch/s", "Fresh/s", "Conv/s", "Missed",
+		"Gap ms", "Bus", "Limit");
+	for (uint8_t c = 0; c < sizeof(MAX31856BenchCounts); c++) {
+		MAX31856BenchRun(MAX31856BenchCounts[c], MAX31856_BUS_ROUND_ROBIN, false, false, LoopMicros, AVGSEL);
+		MAX31856BenchRun(MAX31856BenchCounts[c], MAX31856_BUS_DRDY_PRIORITY, false, false, LoopMicros, AVGSEL);
+		MAX31856BenchRun(MAX31856BenchCounts[c], MAX31856_BUS_DRDY_PRIORITY, true, false, LoopMicros, AVGSEL);
+		MAX31856BenchRun(MAX31856BenchCounts[c], MAX31856_BUS_DRDY_PRIORITY, false, true, LoopMicros, AVGSEL);
+		MAX31856BenchRun(MAX31856BenchCounts[c], MAX31856_BUS_DRDY_PRIORITY, true, true, LoopMicros, AVGSEL);
+		printf("\n");
+	}
+	return 0;
+} //===============================================================================================
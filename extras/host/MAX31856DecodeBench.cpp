@@ -0,0 +1,117 @@
+/*
+Host CPU time of the LTC/CJT decode paths
+GitHub.com/TerryJMyers
+
+Times each way of getting a temperature out of a register image over a table of register images, and prints ns per
+sample:
+	Original double		the original MAX31856Calculate() LTCT arithmetic (sign fix, shift, double multiply)
+	DecodeLTC			MAX31856DecodeLTC(), integer 1/128C
+	DecodeLTC + double	MAX31856LTCToDouble(MAX31856DecodeLTC()), the same double as the original
+	CalculateFixed		MAX31856CalculateFixed(), LTC + CJT + SR into MAX31856_Fixed_Struct
+	Calculate			MAX31856Calculate(), every double in MAX31856_REG_Struct
+A PC has a hardware FPU so the gap here is much smaller than on an AVR, where each double multiply is a library call of
+100+ cycles and the integer decode is a handful of shifts.  Use it to compare the paths against each other, not as target
+timings.  extras/host/MAX31856DecodeCheck.cpp shows the integer path gives bit for bit the same doubles.
+It then prints the RAM each device takes: the original library kept one MAX31856_REG_Struct per chip, a device handle
+(MAX31856_Device_Struct) embeds that same struct, doubles and all, and adds its pins, write shadow and timestamps.
+The doubles column is what the fixed point path leaves unused.  On an AVR a double is 4 bytes, so there they are half of
+what a PC shows.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856DecodeBench extras/host/MAX31856DecodeBench.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+
+#include <chrono>
+
+#define MAX31856_BENCH_IMAGES	1024		//Register images cycled through, a power of 2
+#define MAX31856_BENCH_PASSES	20000
+
+struct MAX31856_REG_Struct MAX31856BenchImages[MAX31856_BENCH_IMAGES];
+
+double MAX31856BenchSeconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+} //===============================================================================================
+
+/*
+The original MAX31856Calculate() LTCT arithmetic
+*/
+double MAX31856BenchOriginal(struct MAX31856_REG_Struct * M) {
+	int32_t temp = M->REG.LTC.H << 16 | M->REG.LTC.M << 8 | M->REG.LTC.L;
+	if (temp & 0x800000) temp |= 0xFF000000;  // fix sign
+	temp >>= 5;  // bottom 5 bits are unused
+	return double(temp) * 0.0078125;
+} //===============================================================================================
+
+void MAX31856BenchPrint(const char * Name, double Start, double Sink, uint32_t Passes = MAX31856_BENCH_PASSES) {
+	double Elapsed = MAX31856BenchSeconds() - Start;
+	if (Sink == 1.0E300) printf(" "); //Keeps the loop from being optimized away
+	printf("%-20s %8.2f\n", Name, Elapsed * 1.0E9 / (double(MAX31856_BENCH_IMAGES) * Passes));
+} //===============================================================================================
+
+int main() {
+	uint32_t Seed = 1;
+	for (uint16_t i = 0; i < MAX31856_BENCH_IMAGES; i++) {
+		Seed = Seed * 1103515245 + 12345;
+		struct MAX31856_REG_Struct * M = &MAX31856BenchImages[i];
+		memset((void *)M, 0, sizeof(struct MAX31856_REG_Struct));
+		M->REG.CR1.TCTYPE = 3;
+		M->REG.LTC.H = uint8_t(Seed >> 24);
+		M->REG.LTC.M = uint8_t(Seed >> 16);
+		M->REG.LTC.L = uint8_t(Seed >> 8) & 0xE0;
+		M->REG.CJT.CJT = int16_t(Seed & 0xFFFC);
+	}
+
+	printf("%-20s %8s\n", "Path", "ns/Sample");
+	double Start, Sink;
+	int32_t IntSink;
+
+	Start = MAX31856BenchSeconds(); Sink = 0;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_BENCH_IMAGES; i++) Sink += MAX31856BenchOriginal(&MAX31856BenchImages[i]);
+	}
+	MAX31856BenchPrint("Original double", Start, Sink);
+
+	Start = MAX31856BenchSeconds(); IntSink = 0;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_BENCH_IMAGES; i++) IntSink += MAX31856DecodeLTC(&MAX31856BenchImages[i].REG);
+	}
+	MAX31856BenchPrint("DecodeLTC", Start, double(IntSink));
+
+	Start = MAX31856BenchSeconds(); Sink = 0;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_BENCH_IMAGES; i++) Sink += MAX31856LTCToDouble(MAX31856DecodeLTC(&MAX31856BenchImages[i].REG));
+	}
+	MAX31856BenchPrint("DecodeLTC + double", Start, Sink);
+
+	Start = MAX31856BenchSeconds(); IntSink = 0;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_BENCH_IMAGES; i++) {
+			struct MAX31856_Fixed_Struct F;
+			MAX31856CalculateFixed(&F, &MAX31856BenchImages[i]);
+			IntSink += F.LTC + F.CJT + F.SR;
+		}
+	}
+	MAX31856BenchPrint("CalculateFixed", Start, double(IntSink));
+
+	Start = MAX31856BenchSeconds(); Sink = 0;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES / 10; p++) { //Slower, fewer passes
+		for (uint16_t i = 0; i < MAX31856_BENCH_IMAGES; i++) {
+			MAX31856Calculate(&MAX31856BenchImages[i]);
+			Sink += MAX31856BenchImages[i].LTCT;
+		}
+	}
+	MAX31856BenchPrint("Calculate", Start, Sink, MAX31856_BENCH_PASSES / 10);
+
+	const size_t Doubles = 7 * sizeof(double); //CJHF through LTCT
+	printf("\n%-32s %6s %8s\n", "RAM per device", "bytes", "doubles");
+	printf("%-32s %6u %8u\n", "Original MAX31856_REG_Struct", unsigned(sizeof(struct MAX31856_REG_Struct)), unsigned(Doubles));
+	printf("%-32s %6u %8u\n", "MAX31856_Device_Struct", unsigned(sizeof(struct MAX31856_Device_Struct)), unsigned(Doubles));
+	printf("%-32s %6u %8u\n", "  of which registers only", unsigned(sizeof(struct MAX31856_REG_MAP_Struct)), 0u);
+	printf("%-32s %6u %8u\n", "MAX31856_Fixed_Struct sample", unsigned(sizeof(struct MAX31856_Fixed_Struct)), 0u);
+#ifdef MAX31856_INSTRUMENTATION
+	printf("(MAX31856_INSTRUMENTATION on, the handle includes %u bytes of counters)\n", unsigned(sizeof(struct MAX31856_Instrument_Struct)));
+#endif
+	return 0;
+} //===============================================================================================
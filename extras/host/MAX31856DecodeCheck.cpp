@@ -0,0 +1,69 @@
+/*
+Bit exact check of the integer decode (MAX31856DecodeLTC(), MAX31856CalculateFixed()) against the original double path
+GitHub.com/TerryJMyers
+
+The original MAX31856Calculate() built LTCT by sign extending the 24 bits of LTCBH/LTCBM/LTCBL into an int32, shifting out
+the 5 unused bits and scaling by 0.0078125 as a double, and CJT by scaling CJTH/CJTL by 0.00390625.  That code is kept here
+as the reference and every possible register value is run through both:
+	LTC		all 2^24 values of LTCBH/LTCBM/LTCBL, MAX31856LTCToDouble(MAX31856DecodeLTC()) and MAX31856Calculate() LTCT
+	CJT		all 2^16 values of CJTH/CJTL, MAX31856CJTToDouble() of the MAX31856CalculateFixed() CJT and MAX31856Calculate() CJT
+Results are compared as bit patterns, not within a tolerance.  Exits with 1 on the first mismatch.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856DecodeCheck extras/host/MAX31856DecodeCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+
+/*
+LTCT and CJT exactly as the original MAX31856Calculate() worked them out
+*/
+double MAX31856ReferenceLTCT(struct MAX31856_REG_Struct * M) {
+	int32_t temp = M->REG.LTC.H << 16 | M->REG.LTC.M << 8 | M->REG.LTC.L;
+	if (temp & 0x800000) temp |= 0xFF000000;  // fix sign
+	temp >>= 5;  // bottom 5 bits are unused
+	return double(temp) * 0.0078125;
+} //===============================================================================================
+double MAX31856ReferenceCJT(struct MAX31856_REG_Struct * M) {
+	return double(M->REG.CJT.CJT) * 0.00390625;
+} //===============================================================================================
+
+bool MAX31856SameBits(double a, double b) {
+	return memcmp(&a, &b, sizeof(double)) == 0;
+} //===============================================================================================
+
+int main() {
+	struct MAX31856_REG_Struct M = {};
+	struct MAX31856_Fixed_Struct F;
+
+	for (uint32_t Code = 0; Code < 0x1000000; Code++) {
+		M.REG.LTC.H = uint8_t(Code >> 16);
+		M.REG.LTC.M = uint8_t(Code >> 8);
+		M.REG.LTC.L = uint8_t(Code);
+		double Reference = MAX31856ReferenceLTCT(&M);
+		MAX31856CalculateFixed(&F, &M);
+		MAX31856Calculate(&M);
+		if (!MAX31856SameBits(MAX31856LTCToDouble(F.LTC), Reference) || !MAX31856SameBits(M.LTCT, Reference)) {
+			printf("LTC 0x%06lX: reference %.7f, fixed %ld (%.7f), MAX31856Calculate() %.7f\nFAIL\n", (unsigned long)Code,
+				Reference, (long)F.LTC, MAX31856LTCToDouble(F.LTC), M.LTCT);
+			return 1;
+		}
+	}
+	printf("LTC: all %lu codes match\n", 0x1000000UL);
+
+	for (uint32_t Code = 0; Code < 0x10000; Code++) {
+		M.REG.CJT.CJT = int16_t(uint16_t(Code));
+		double Reference = MAX31856ReferenceCJT(&M);
+		MAX31856CalculateFixed(&F, &M);
+		MAX31856Calculate(&M);
+		if (!MAX31856SameBits(MAX31856CJTToDouble(F.CJT), Reference) || !MAX31856SameBits(M.CJT, Reference)) {
+			printf("CJT 0x%04lX: reference %.8f, fixed %d (%.8f), MAX31856Calculate() %.8f\nFAIL\n", (unsigned long)Code,
+				Reference, F.CJT, MAX31856CJTToDouble(F.CJT), M.CJT);
+			return 1;
+		}
+	}
+	printf("CJT: all %lu codes match\n", 0x10000UL);
+
+	printf("PASS\n");
+	return 0;
+} //===============================================================================================
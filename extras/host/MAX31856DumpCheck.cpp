@@ -0,0 +1,333 @@
+/*
+Heap allocations and host CPU time of the register map dumps, String against Print
+GitHub.com/TerryJMyers
+
+Allocation test, counted with MAX31856HostStringAllocations (the allocations the Arduino String would make):
+	every MAX31856PrintREGMap*() dump to a Print		0 allocations, this is the point of the Print versions
+	MAX31856GetREGMapString() into a String reserved to MAX31856_REGMAP_MAX_LEN		1 allocation, the reserve itself
+and every dump has to come out the same through a Print, a MAX31856BufferPrint and a String, byte for byte the same as the
+original String version of it, and no longer than its MAX31856_*_MAX_LEN.  The register images are random, with every CR0
+value, and go through MAX31856Calculate() first so the Temp dump has real doubles to print.  The Temp dump of the voltage
+modes (TCTYPE 8-15) is left out of the comparison, it prints the input in mV there where the original printed a
+meaningless temperature.  Exits with 1 on any failure.
+Timing, ns per register map dump and allocations per dump for:
+	Original String		the original MAX31856GetREGMapString(), a String temporary per register
+	GetREGMapString		the current MAX31856GetREGMapString() into an empty String
+	Reserved String		the same into a String reserved to MAX31856_REGMAP_MAX_LEN
+	BufferPrint			MAX31856PrintREGMap() into a fixed buffer
+	Print				MAX31856PrintREGMap() to a Print that throws the bytes away (the cost of formatting alone)
+On an AVR each allocation is a malloc/realloc of a few hundred cycles plus heap fragmentation, so the allocation column
+matters more there than the host timings.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856DumpCheck extras/host/MAX31856DumpCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+
+#include <chrono>
+
+#define MAX31856_CHECK_IMAGES	256
+#define MAX31856_BENCH_PASSES	200
+
+/*
+The original String dumps, copied from the first version of MAX31856.h with only their names changed, and in the CR0 one
+the global MAX31856 it read in place of M replaced by M
+*/
+void MAX31856OriginalREGMapString(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	s += F("Register Memory Map:\r\n");
+	s += F("\r\n	CR0:	"); s += ByteToBinaryAndHex(M->REG.CR0.WORD);
+	s += F("\r\n	CR1:	"); s += ByteToBinaryAndHex(M->REG.CR1.WORD);
+	s += F("\r\n	MASK:	"); s += ByteToBinaryAndHex(M->REG.MASK.WORD);
+	s += F("\r\n	CJHF:	"); s += ByteToBinaryAndHex((uint8_t)M->REG.CJHF);
+	s += F("\r\n	CJLF:	"); s += ByteToBinaryAndHex((uint8_t)M->REG.CJLF);
+	s += F("\r\n	LTHFTH:	"); s += ByteToBinaryAndHex(M->REG.LTHFT.H);
+	s += F("\r\n	LTHFTL:	"); s += ByteToBinaryAndHex(M->REG.LTHFT.L);
+	s += F("\r\n	LTLFTH:	"); s += ByteToBinaryAndHex(M->REG.LTLFT.H);
+	s += F("\r\n	LTLFTL:	"); s += ByteToBinaryAndHex(M->REG.LTLFT.L);
+	s += F("\r\n	CJTO:	"); s += ByteToBinaryAndHex((uint8_t)M->REG.CJTO);
+	s += F("\r\n	CJTH:	"); s += ByteToBinaryAndHex(M->REG.CJT.H);
+	s += F("\r\n	CJTL:	"); s += ByteToBinaryAndHex(M->REG.CJT.L);
+	s += F("\r\n	LTCBH:	"); s += ByteToBinaryAndHex(M->REG.LTC.H);
+	s += F("\r\n	LTCBM:	"); s += ByteToBinaryAndHex(M->REG.LTC.M);
+	s += F("\r\n	LTCBL:	"); s += ByteToBinaryAndHex(M->REG.LTC.L);
+	s += F("\r\n	SR:	"); s += ByteToBinaryAndHex(M->REG.SR.WORD);
+	s += F("\r\n");
+} //===============================================================================================
+void MAX31856OriginalCR0String(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	s += F("CR0 (Configuration Register)\r\n");
+	s += StringIndent(F("	MODE"), 2);			(M->REG.CR0.CMODE) ? s += F("Continuous Conversion Mode") : s += F("Normally Off (One Shot)	*Default"); s += F("\r\n");
+	s += StringIndent(F("	1SHOT"), 2);		
+		if (M->REG.CR0.CMODE) {//if continuous conversion this does nothing
+			s += F("N/A: No effect in Continuous Conversion Mode");
+		}
+		else {
+			(M->REG.CR0.ONESHOT) ? s += F("Conversion ready or active") : s += F("No conversion active	*Default");
+			s += F("\r\n");
+		}	
+	s += StringIndent(F("	OCFAULT"), 2);
+		if (M->REG.CR0.OCFAULT0 ==false && M->REG.CR0.OCFAULT1 == false) {
+			s += F("Open Circuit Detection DISABLED");
+		}
+		else if (M->REG.CR0.OCFAULT0 == true && M->REG.CR0.OCFAULT1 == false) {	
+			s += F("Open Circuit Detection ENABLED. Fault Detection Time ~");  (M->REG.CR0.CJ) ? s += F("13.3ms-15ms") : s += F("40ms-44ms");		
+		}
+		else if (M->REG.CR0.OCFAULT0 == false && M->REG.CR0.OCFAULT1 == true) {
+			s += F("Open Circuit Detection ENABLED. Fault Detection Time ~");  (M->REG.CR0.CJ) ? s += F("33.4ms-37ms") : s += F("60ms-66ms");
+		}
+		else if (M->REG.CR0.OCFAULT0 == true && M->REG.CR0.OCFAULT1 == true) {
+			s += F("Open Circuit Detection ENABLED. Fault Detection Time ~");  (M->REG.CR0.CJ) ? s += F("113.4ms-125ms") : s += F("140ms-154ms");
+		}
+		s += F("\r\n");
+	s += StringIndent(F("	CJ"), 2);			(M->REG.CR0.CJ) ? s += F("CJ DISABLED") : s += F("CJ ENABLED	*Default"); s += F("\r\n");
+	s += StringIndent(F("	FAULT"), 2);		(M->REG.CR0.FAULT) ? s += F("FAULT pin and fault bits are latched and requires a FAULTCLR cmd") : s += F("FAULT pin and fault bits are automatically Reset	*Default"); s += F("\r\n");
+	s += StringIndent(F("	FAULTCLR"), 2);		(M->REG.CR0.FAULTCLR) ? s += F("Set to clear faults") : s += F("N/A: No effect in FAULT mode 0	*Default"); s += F("\r\n");
+	s += StringIndent(F("	50/60Hz"), 2);		(M->REG.CR0.Hz50_60) ? s += F("50Hz notch filter") : s += F("60hz notch filter	*Default"); s += F("\r\n");
+
+} //===============================================================================================
+void MAX31856OriginalCR1String(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+
+	s += F("CR1 (Configuration Register)\r\n");
+	uint8_t AveragedSamples;
+	if (M->REG.CR1.AVGSEL == 0) {
+		s += F("	AVGSEL: Sample Averaging DISABLED\r\n"); AveragedSamples = 1;
+	} else if (M->REG.CR1.AVGSEL == 1) {
+		s += F("	AVGSEL: 2 Samples Averaged\r\n"); AveragedSamples = 2;
+	}
+	else if (M->REG.CR1.AVGSEL == 2) {
+		s += F("	AVGSEL: 4 Samples Averaged\r\n"); AveragedSamples = 4;
+	}
+	else if (M->REG.CR1.AVGSEL == 3) {
+		s += F("	AVGSEL: 8 Samples Averaged\r\n"); AveragedSamples = 8;
+	}
+	else if (M->REG.CR1.AVGSEL >= 4 && M->REG.CR1.AVGSEL <= 7) {
+		s += F("	AVGSEL: 16 Sample Averaging Enabled\r\n");	AveragedSamples = 16;
+	}
+	else {
+		s += F("	AVGSEL: ERROR detecing sample averaging status\r\n"); AveragedSamples = 0;
+	}
+
+	float Tconv;
+	float TconvMax;
+	if (M->REG.CR0.CMODE) { //automatic conversion
+		if (M->REG.CR0.Hz50_60) { //50hz
+			Tconv = 98.0		+ float(AveragedSamples - 1) * 20.0;
+			TconvMax = 110.0	+ float(AveragedSamples - 1) * 20.0;
+		}
+		else {//60hz
+			Tconv = 82.0		+ float(AveragedSamples - 1) * 16.67;
+			TconvMax = 90.0		+ float(AveragedSamples - 1) * 16.67;
+		}
+	}
+	else {//one shot conversion
+		if (M->REG.CR0.Hz50_60) { //50hz
+			Tconv = 169.0		+ float(AveragedSamples - 1) * 40.0;
+			TconvMax = 185.0	+ float(AveragedSamples - 1) * 40.0;
+		}
+		else {//60hz
+			Tconv = 143.0		+ float(AveragedSamples - 1) * 33.3;
+			TconvMax = 155.0	+ float(AveragedSamples - 1) * 33.3;
+		}
+	}
+	s += F("	Estimated Conversion Time:	"); s += String(Tconv); s += F("ms typical, ");  s += String(TconvMax); s += F("ms Maximum\r\n");
+	s += F("	TC Type:	");
+	if (M->REG.CR1.TCTYPE == 0)	s += F("B");
+	if (M->REG.CR1.TCTYPE == 1)	s += F("E");
+	if (M->REG.CR1.TCTYPE == 2)	s += F("J");
+	if (M->REG.CR1.TCTYPE == 3)	s += F("K");
+	if (M->REG.CR1.TCTYPE == 4)	s += F("N");
+	if (M->REG.CR1.TCTYPE == 5)	s += F("R");
+	if (M->REG.CR1.TCTYPE == 6)	s += F("S");
+	if (M->REG.CR1.TCTYPE == 7)	s += F("T");
+	if (M->REG.CR1.TCTYPE >= 8 && M->REG.CR1.TCTYPE <= 11)	s += F("Voltage 8 X gain");
+	if (M->REG.CR1.TCTYPE >= 12 && M->REG.CR1.TCTYPE <= 15)	s += F("Voltage 32 X gain");
+	s += F("\r\n");
+} //===============================================================================================
+void MAX31856OriginalMASKString(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	s += F("MASK (Fault Mask Register)");
+	s += F("\r\n	(bit5)CJ High FAULT Mask =	"); s += M->REG.MASK.CJ_HIGH_FAULT_MASK;
+	s += F("\r\n	(bit4)CJ Low FAULT Mask =	"); s += M->REG.MASK.CJ_LOW_FAULT_MASK; 
+	s += F("\r\n	(bit3)TC High FAULT Mask =	"); s += M->REG.MASK.TC_HIGH_FAULT_MASK;
+	s += F("\r\n	(bit2)TC Low FAULT Mask =	"); s += M->REG.MASK.TC_LOW_FAULT_MASK; 
+	s += F("\r\n	(bit1)OV/UV FAULT Mask =	"); s += M->REG.MASK.OV_UV_FAULT_MASK;
+	s += F("\r\n	(bit0)Open FAULT Mask =	"); s += M->REG.MASK.OPEN_FAULT_MASK;
+	s += F("\r\n");
+} //===============================================================================================
+void MAX31856OriginalFAULTString(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	s += F("Fault Status Register SR)\r\n");
+	s += StringIndent(F("	CJ Range"), 2);		(M->REG.SR.CJ_Range) ? s += F("	ERROR: The Cold-Junction temperature is outside of the normal operating range.") : s += F("	OK: The Cold-Junction temperature is within the normal operating range (-55C to +125C for types E,J, K, N, and T; -50C to + 125C for types R and S; 0 to 125C for type B).)"); s += F("\r\n");
+	s += StringIndent(F("	TC Range"), 2);		(M->REG.SR.TC_Range) ? s += F("	ERROR: The Thermocouple Hot Junction temperature is outside of the normal operating range.") : s += F("	OK: The Thermocouple Hot Junction temperature is within the normal operating range"); s += F("\r\n");
+	s += StringIndent(F("	CJHIGH"), 2);		(M->REG.SR.CJHIGH) ? s += F("	ERROR: The Thermocouple Hot Junction temperature is outside of the normal operating range.") : s += F("	OK: The Cold-Junction temperature is higher than the cold-junction temperature high threshold"); s += F("\r\n");
+	s += StringIndent(F("	CJLOW"), 2);		(M->REG.SR.CJLOW) ? s += F("	ERROR: The Cold-Junction temperature is lower than the cold-junction temperature low threshold") : s += F("	OK: The Cold-Junction temperature is at or higher than the cold-junction temperature low threshold "); s += F("\r\n");
+	s += StringIndent(F("	TCHIGH"), 2);		(M->REG.SR.TCHIGH) ? s += F("	ERROR: The Thermocouple Temperature is higher than the thermocouple temperature high threshold.") : s += F("	OK: The Thermocouple Temperature is higher than the thermocouple temperature high threshold "); s += F("\r\n");
+	s += StringIndent(F("	TCLOW"), 2);		(M->REG.SR.TCLOW) ? s += F("	ERROR: Thermocouple temperature is lower than the thermocouple temperature low threshold. ") : s += F("	OK: Thermocouple temperature is at or higher than the thermocouple temperature low threshold "); s += F("\r\n");
+	s += StringIndent(F("	OVUV"), 2);			(M->REG.SR.OVUV) ? s += F("	ERROR: The input voltage is negative or greater than VDD") : s += F("	OK: The input voltage is positive and less than VDD"); s += F("\r\n");
+	s += StringIndent(F("	OPEN"), 2);			(M->REG.SR.OPEN) ? s += F("	ERROR: An open circuit such as broken thermocouple wires has been detected. ") : s += F("	OK: No open circuit or broken thermocouple wires are detected "); s += F("\r\n");
+} //===============================================================================================
+void MAX31856OriginalTempString(String &s, struct MAX31856_REG_Struct * M = &MAX31856) {
+	s += F("CJHF (Cold Junction High Fault Threshold): "); s += M->CJHF; s += F("C\r\n");
+	s += F("CJLF (Cold Junction Low Fault Threshold): "); s += M->CJLF; s += F("C\r\n");
+	s += F("LTHFTH + LTHFTL (Linearized Temperature High Fault Threshold MSB + LSB): ");   s += String(M->LTHFT, 3); s += F("C\r\n");
+	s += F("LTLFTH + LTLFTL (Linearized Temperature Low Fault Threshold MSB + LSB): ");   s += String(M->LTLFT, 3); s += F("C\r\n");
+	s += F("CJTO (Cold Junction Temperature Offset): "); s += String(M->CJTO, 3); s += F("C\r\n");
+	s += F("CJTH + CJTL (Cold Junction Temperature): "); s += String(M->CJT, 3); s += F("C\r\n");
+	s += F("LTCMH + LTCBM + LTCBL (Linearized TC Temperature): "); s += String(M->LTCT, 4); s += F("C\r\n");
+} //===============================================================================================
+
+/*
+A Print that keeps nothing but a count and a checksum of what went through it
+*/
+class MAX31856NullPrint : public Print {
+public:
+	uint32_t Bytes = 0;
+	uint32_t Sum = 0;
+	using Print::write;
+	size_t write(uint8_t c) {
+		Bytes++;
+		Sum = Sum * 31 + c;
+		return 1;
+	}
+};
+
+struct MAX31856Dump_Struct {
+	const char * Name;
+	void (*ToPrint)(Print &p, struct MAX31856_REG_Struct * M);
+	void (*ToString)(String &s, struct MAX31856_REG_Struct * M);
+	void (*Original)(String &s, struct MAX31856_REG_Struct * M);
+	uint16_t MaxLength;
+};
+const struct MAX31856Dump_Struct MAX31856Dumps[] = {
+	{ "REGMap",	MAX31856PrintREGMap,		MAX31856GetREGMapString,		MAX31856OriginalREGMapString,	MAX31856_REGMAP_MAX_LEN },
+	{ "CR0",	MAX31856PrintREGMapCR0,		MAX31856GetREGMapStringCR0,		MAX31856OriginalCR0String,		MAX31856_CR0_MAX_LEN },
+	{ "CR1",	MAX31856PrintREGMapCR1,		MAX31856GetREGMapStringCR1,		MAX31856OriginalCR1String,		MAX31856_CR1_MAX_LEN },
+	{ "MASK",	MAX31856PrintREGMapMASK,	MAX31856GetREGMapStringMASK,	MAX31856OriginalMASKString,		MAX31856_MASK_MAX_LEN },
+	{ "FAULT",	MAX31856PrintREGMapFAULT,	MAX31856GetREGMapStringFAULT,	MAX31856OriginalFAULTString,	MAX31856_FAULT_MAX_LEN },
+	{ "Temp",	MAX31856PrintREGMapTemp,	MAX31856GetREGMapStringTemp,	MAX31856OriginalTempString,		MAX31856_TEMP_MAX_LEN },
+};
+#define MAX31856_NUM_DUMPS	(sizeof(MAX31856Dumps) / sizeof(MAX31856Dumps[0]))
+
+struct MAX31856_REG_Struct MAX31856CheckImages[MAX31856_CHECK_IMAGES];
+
+double MAX31856BenchSeconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+} //===============================================================================================
+
+void MAX31856BenchPrint(const char * Name, double Start, uint32_t Allocations) {
+	double Dumps = double(MAX31856_CHECK_IMAGES) * MAX31856_BENCH_PASSES;
+	printf("%-18s %10.0f %12.2f\n", Name, (MAX31856BenchSeconds() - Start) * 1.0E9 / Dumps, double(Allocations) / Dumps);
+} //===============================================================================================
+
+int main() {
+	bool Pass = true;
+	uint32_t Seed = 1;
+	for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) {
+		uint8_t Registers[16];
+		for (uint8_t r = 0; r < sizeof(Registers); r++) {
+			Seed = Seed * 1103515245 + 12345;
+			Registers[r] = uint8_t(Seed >> 16);
+		}
+		Registers[0] = uint8_t(i); //Every CR0 value
+		Registers[1] &= 0x7F; //CR1 bit 7 is reserved, every AVGSEL and TCTYPE (voltage modes 8-15 included) still comes up
+		MAX31856UnpackRegisters(&MAX31856CheckImages[i], &Registers[0]);
+		MAX31856Calculate(&MAX31856CheckImages[i]);
+	}
+
+	//Allocations, identical output, same as the original and within the length limit
+	uint32_t PrintAllocations = 0, StringAllocations = 0, Mismatches = 0;
+	printf("%-8s %8s %8s %10s %10s\n", "Dump", "Longest", "MAX_LEN", "Compared", "Original");
+	for (uint8_t d = 0; d < MAX31856_NUM_DUMPS; d++) {
+		const struct MAX31856Dump_Struct * Dump = &MAX31856Dumps[d];
+		uint32_t Longest = 0, Compared = 0, Differ = 0;
+		for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) {
+			struct MAX31856_REG_Struct * M = &MAX31856CheckImages[i];
+			char Buffer[1024];
+			uint32_t Before = MAX31856HostStringAllocations;
+			MAX31856NullPrint Null;
+			Dump->ToPrint(Null, M);
+			MAX31856BufferPrint BufferPrint(Buffer, sizeof(Buffer));
+			Dump->ToPrint(BufferPrint, M);
+			PrintAllocations += MAX31856HostStringAllocations - Before;
+
+			String s;
+			s.reserve(Dump->MaxLength);
+			Before = MAX31856HostStringAllocations;
+			Dump->ToString(s, M);
+			StringAllocations += MAX31856HostStringAllocations - Before;
+			if (Null.Bytes != s.length() || strcmp(Buffer, s.c_str()) != 0 || BufferPrint.Overflow) Mismatches++;
+			if (Null.Bytes > Longest) Longest = Null.Bytes;
+
+			if (Dump->ToPrint == MAX31856PrintREGMapTemp && MAX31856VoltageGain(M)) continue;
+			String Original;
+			Dump->Original(Original, M);
+			Compared++;
+			if (Original.length() != Null.Bytes || memcmp(Original.c_str(), Buffer, Null.Bytes) != 0) Differ++;
+		}
+		printf("%-8s %8lu %8u %10lu %10s\n", Dump->Name, (unsigned long)Longest, Dump->MaxLength, (unsigned long)Compared,
+			Differ ? "DIFFERS" : "same");
+		if (Longest > Dump->MaxLength || Differ != 0) Pass = false;
+	}
+	printf("Print dumps: %lu allocations, reserved String dumps: %lu allocations past the reserve, mismatched output: %lu\n",
+		(unsigned long)PrintAllocations, (unsigned long)StringAllocations, (unsigned long)Mismatches);
+	if (PrintAllocations != 0 || StringAllocations != 0 || Mismatches != 0) Pass = false;
+
+	printf("\n");
+
+	//Timing
+	printf("%-18s %10s %12s\n", "Register map", "ns/Dump", "Allocs/Dump");
+	double Start;
+	uint32_t Before;
+	uint32_t Sink = 0;
+
+	Start = MAX31856BenchSeconds(); Before = MAX31856HostStringAllocations;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) {
+			String s;
+			MAX31856OriginalREGMapString(s, &MAX31856CheckImages[i]);
+			Sink += s.length();
+		}
+	}
+	MAX31856BenchPrint("Original String", Start, MAX31856HostStringAllocations - Before);
+
+	Start = MAX31856BenchSeconds(); Before = MAX31856HostStringAllocations;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) {
+			String s;
+			MAX31856GetREGMapString(s, &MAX31856CheckImages[i]);
+			Sink += s.length();
+		}
+	}
+	MAX31856BenchPrint("GetREGMapString", Start, MAX31856HostStringAllocations - Before);
+
+	Start = MAX31856BenchSeconds(); Before = MAX31856HostStringAllocations;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) {
+			String s;
+			s.reserve(MAX31856_REGMAP_MAX_LEN);
+			MAX31856GetREGMapString(s, &MAX31856CheckImages[i]);
+			Sink += s.length();
+		}
+	}
+	MAX31856BenchPrint("Reserved String", Start, MAX31856HostStringAllocations - Before);
+
+	Start = MAX31856BenchSeconds(); Before = MAX31856HostStringAllocations;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) {
+			char Buffer[MAX31856_REGMAP_MAX_LEN + 1];
+			MAX31856BufferPrint BufferPrint(Buffer, sizeof(Buffer));
+			MAX31856PrintREGMap(BufferPrint, &MAX31856CheckImages[i]);
+			Sink += Buffer[i % MAX31856_REGMAP_MAX_LEN];
+		}
+	}
+	MAX31856BenchPrint("BufferPrint", Start, MAX31856HostStringAllocations - Before);
+
+	Start = MAX31856BenchSeconds(); Before = MAX31856HostStringAllocations;
+	MAX31856NullPrint Null;
+	for (uint32_t p = 0; p < MAX31856_BENCH_PASSES; p++) {
+		for (uint16_t i = 0; i < MAX31856_CHECK_IMAGES; i++) MAX31856PrintREGMap(Null, &MAX31856CheckImages[i]);
+	}
+	MAX31856BenchPrint("Print", Start, MAX31856HostStringAllocations - Before);
+	if (Sink + Null.Sum == 0) printf(" "); //Keeps the loops from being optimized away
+
+	printf("\n%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================
@@ -0,0 +1,184 @@
+/*
+MAX31856FaultService() debounce and latch handling against the simulator
+GitHub.com/TerryJMyers
+
+Runs a simulated MAX31856 in automatic conversion with a DRDY pin, injects an open thermocouple (Sim.InjectedFaults) for a
+single conversion or for a stretch of time, and checks what MAX31856FaultService() reports for it:
+	glitch, debounce 2		a fault on one conversion is not reported at all
+	held, debounce 2		one raise and one clear, timed from the first and last faulty conversions
+	latched, no AutoClear	CR0.FAULT latches SR, the raise is reported and the clear never is
+	latched, glitch			AutoClear sees the fault go on the next conversion
+	latched, held 3s		FAULTCLR once when the fault appears and then once per ClearMicros, not on every conversion,
+							and the clear is reported within ClearMicros of the fault going
+	FAULTCLR from shadow	a CR0 change staged in D->M but not written is not sent along with FAULTCLR
+Prints one row per case and exits with 1 if any failed, or if the simulator stops converting during a case.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856FaultCheck extras/host/MAX31856FaultCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856Sim.h"
+
+#define MAX31856_CHECK_LOOP_MICROS		1000	//Main loop pass
+#define MAX31856_CHECK_STALL_MICROS		5000000	//No conversion for this long fails the case, e.g. CMODE written off
+
+MAX31856Sim_Struct MAX31856CheckSim;
+MAX31856_Device_Struct MAX31856CheckTC;
+MAX31856_Fault_Struct MAX31856CheckFaults;
+uint32_t MAX31856CheckRaised, MAX31856CheckCleared;
+struct MAX31856_FaultEvent_Struct MAX31856CheckRaise, MAX31856CheckClear;	//Last of each
+bool MAX31856CheckStalled;
+
+void MAX31856CheckEvent(struct MAX31856_Fault_Struct * F, struct MAX31856_FaultEvent_Struct * E) {
+	(void)F;
+	if (E->Raised) {
+		MAX31856CheckRaised++;
+		MAX31856CheckRaise = *E;
+	}
+	else {
+		MAX31856CheckCleared++;
+		MAX31856CheckClear = *E;
+	}
+} //===============================================================================================
+
+/*
+Fresh simulator and device, automatic conversion with thresholds that never trip, Latch sets CR0.FAULT
+*/
+void MAX31856CheckBegin(bool Latch, uint8_t Debounce, bool AutoClear) {
+	MAX31856SimBegin(&MAX31856CheckSim, 10, 20);
+	MAX31856CheckSim.Temperature = 100.0;
+	MAX31856SimAttach(&MAX31856CheckSim, 1);
+	MAX31856Begin(&MAX31856CheckTC, 10, 20);
+	MAX31856CheckTC.M.REG.CR0.CMODE = true;
+	MAX31856CheckTC.M.REG.CR0.FAULT = Latch;
+	MAX31856CheckTC.M.REG.CR1.TCTYPE = 3;
+	MAX31856CheckTC.M.REG.LTHFT.LTHFT = 0x7FFF;
+	MAX31856CheckTC.M.REG.LTLFT.LTLFT = -0x8000;
+	MAX31856CheckTC.M.REG.CJHF = 127;
+	MAX31856CheckTC.M.REG.CJLF = -128;
+	MAX31856WriteRegisters(&MAX31856CheckTC);
+	MAX31856FaultBegin(&MAX31856CheckFaults, &MAX31856CheckTC, MAX31856CheckEvent);
+	MAX31856CheckFaults.Debounce = Debounce;
+	MAX31856CheckFaults.AutoClear = AutoClear;
+	MAX31856CheckRaised = 0;
+	MAX31856CheckCleared = 0;
+	MAX31856CheckStalled = false;
+} //===============================================================================================
+
+/*
+One main loop pass: read and service the device if DRDY is down
+*/
+void MAX31856CheckLoop() {
+	if (MAX31856DataReady(&MAX31856CheckTC)) {
+		MAX31856ReadCJAndTemperature(&MAX31856CheckTC);
+		MAX31856FaultService(&MAX31856CheckFaults);
+	}
+	MAX31856HostAdvanceMicros(MAX31856_CHECK_LOOP_MICROS);
+} //===============================================================================================
+void MAX31856CheckRun(uint32_t Micros) {
+	uint32_t Start = micros();
+	while (micros() - Start < Micros) MAX31856CheckLoop();
+} //===============================================================================================
+
+/*
+Run until the simulator has completed Count more conversions, returns the simulated time of the last one in micros()
+*/
+uint32_t MAX31856CheckConversions(uint32_t Count) {
+	uint32_t Target = MAX31856CheckSim.Conversions + Count;
+	uint32_t Start = micros();
+	while (MAX31856CheckSim.Conversions < Target) {
+		if (micros() - Start > MAX31856_CHECK_STALL_MICROS) {
+			MAX31856CheckStalled = true;
+			return micros();
+		}
+		MAX31856CheckLoop();
+		MAX31856SimUpdateAll();
+	}
+	return uint32_t(MAX31856CheckSim.DoneNanos / 1000ull) - uint32_t(MAX31856SimConversionNanos(&MAX31856CheckSim) / 1000ull);
+} //===============================================================================================
+
+bool MAX31856CheckRow(const char * Name, bool Pass) {
+	Pass = Pass && !MAX31856CheckStalled;
+	printf("%-24s %6lu %7lu %6lu %5s\n", Name, (unsigned long)MAX31856CheckRaised, (unsigned long)MAX31856CheckCleared,
+		(unsigned long)MAX31856CheckFaults.Clears, Pass ? "ok" : "FAIL");
+	return Pass;
+} //===============================================================================================
+
+int main() {
+	bool Pass = true;
+	float Tconv, TconvMax;
+	printf("%-24s %6s %7s %6s\n", "Case", "Raised", "Cleared", "Clears");
+
+	//A single faulty conversion inside the debounce
+	MAX31856CheckBegin(false, 2, false);
+	MAX31856CheckRun(1000000);
+	MAX31856CheckSim.InjectedFaults = MAX31856_FAULT_OPEN;
+	MAX31856CheckConversions(1);
+	MAX31856CheckSim.InjectedFaults = 0;
+	MAX31856CheckRun(1000000);
+	Pass &= MAX31856CheckRow("glitch, debounce 2", MAX31856CheckRaised == 0 && MAX31856CheckCleared == 0);
+
+	//Ten faulty conversions: one raise stamped at the first of them, one clear stamped at the first good one
+	MAX31856CheckBegin(false, 2, false);
+	MAX31856ConversionTime(&Tconv, &TconvMax, &MAX31856CheckTC.M);
+	MAX31856CheckRun(1000000);
+	MAX31856CheckSim.InjectedFaults = MAX31856_FAULT_OPEN;
+	uint32_t First = MAX31856CheckConversions(1);
+	MAX31856CheckConversions(9);
+	MAX31856CheckSim.InjectedFaults = 0;
+	uint32_t Good = MAX31856CheckConversions(1);
+	MAX31856CheckRun(1000000);
+	Pass &= MAX31856CheckRow("held, debounce 2", MAX31856CheckRaised == 1 && MAX31856CheckCleared == 1
+		&& MAX31856CheckRaise.Fault == MAX31856_FAULT_OPEN
+		&& MAX31856CheckRaise.Micros - First < uint32_t(Tconv * 100.0)		//Read within a tenth of Tconv of the edge
+		&& MAX31856CheckClear.Micros - Good < uint32_t(Tconv * 100.0)
+		&& MAX31856CheckFaults.Reported == 0);
+
+	//Latched with nothing clearing it: reported once, still raised after the fault has gone
+	MAX31856CheckBegin(true, 0, false);
+	MAX31856CheckRun(1000000);
+	MAX31856CheckSim.InjectedFaults = MAX31856_FAULT_OPEN;
+	MAX31856CheckConversions(1);
+	MAX31856CheckSim.InjectedFaults = 0;
+	MAX31856CheckRun(2000000);
+	Pass &= MAX31856CheckRow("latched, no AutoClear", MAX31856CheckRaised == 1 && MAX31856CheckCleared == 0
+		&& MAX31856CheckFaults.Reported == MAX31856_FAULT_OPEN && MAX31856CheckFaults.Clears == 0);
+
+	//Latched, AutoClear: a fault on one conversion is cleared and reported gone on the next
+	MAX31856CheckBegin(true, 0, true);
+	MAX31856CheckRun(1000000);
+	MAX31856CheckSim.InjectedFaults = MAX31856_FAULT_OPEN;
+	MAX31856CheckConversions(1);
+	MAX31856CheckSim.InjectedFaults = 0;
+	MAX31856CheckRun(1000000);
+	Pass &= MAX31856CheckRow("latched, glitch", MAX31856CheckRaised == 1 && MAX31856CheckCleared == 1
+		&& MAX31856CheckClear.DurationMicros < uint32_t(TconvMax * 1100.0) && MAX31856CheckFaults.Clears == 1);
+
+	//Latched, AutoClear, a fault held for 3s: clears at the start and once a second, the clear seen within ClearMicros
+	MAX31856CheckBegin(true, 0, true);
+	MAX31856CheckRun(1000000);
+	MAX31856CheckSim.InjectedFaults = MAX31856_FAULT_OPEN;
+	MAX31856CheckRun(3000000);
+	uint32_t Held = MAX31856CheckFaults.Clears;
+	MAX31856CheckSim.InjectedFaults = 0;
+	uint32_t Gone = micros();
+	MAX31856CheckRun(2000000);
+	Pass &= MAX31856CheckRow("latched, held 3s", MAX31856CheckRaised == 1 && MAX31856CheckCleared == 1
+		&& Held >= 3 && Held <= 4
+		&& MAX31856CheckClear.Micros - Gone <= MAX31856CheckFaults.ClearMicros + uint32_t(TconvMax * 2000.0));
+
+	//FAULTCLR is built from the CR0 on the chip, the staged CMODE = false must not go out with it
+	MAX31856CheckBegin(true, 0, true);
+	MAX31856CheckRun(1000000);
+	MAX31856CheckTC.M.REG.CR0.CMODE = false;
+	MAX31856CheckSim.InjectedFaults = MAX31856_FAULT_OPEN;
+	MAX31856CheckConversions(2);
+	MAX31856CheckRun(10000);
+	MAX31856CheckSim.InjectedFaults = 0;
+	Pass &= MAX31856CheckRow("FAULTCLR from shadow", MAX31856CheckFaults.Clears >= 1 && (MAX31856CheckSim.Registers[0] & 0x80)
+		&& (MAX31856CheckSim.Registers[0] & 0x04) && !(MAX31856CheckSim.Registers[0] & 0x40));
+
+	printf("\n%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================
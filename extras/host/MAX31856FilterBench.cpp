@@ -0,0 +1,196 @@
+/*
+Noise and latency of MAX31856_Filter_Struct against hardware averaging (CR1.AVGSEL)
+GitHub.com/TerryJMyers
+
+Runs the simulated MAX31856 in automatic conversion mode at every AVGSEL with each filter setup and prints:
+	Tconv		typical conversion time from MAX31856ConversionTime()
+	Noise		standard deviation of the output at a constant temperature, C
+	T90			time from a 10C step of the hot junction to the output covering 90% of it, ms
+	T90 small	the same for a step of MAX31856_BENCH_SMALL_STEP times the noise of one conversion at that AVGSEL.  It is
+				inside the 3 sigma gate of the Kalman filter, so the gain stays shut and the step comes through as slowly
+				as through an EMA, where the 10C step opens the gate: the price of the low noise
+	Ramp lag	mean time the output trails a MAX31856_BENCH_RAMP C/s ramp by, ms
+	ns/Sample	host CPU time of MAX31856FilterUpdate()
+Both T90 are taken from the mean response over all steps, up and down, so noise on single steps does not set off an early
+crossing.  The simulator latches the temperature at the end of each conversion, so the chip side of T90 is only the wait for
+the next conversion and the real AVGSEL latency is somewhat longer than shown.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856FilterBench extras/host/MAX31856FilterBench.cpp
+
+Usage:
+	MAX31856FilterBench [NoiseC]
+		NoiseC is the standard deviation of a single unaveraged conversion in C, default 0.2
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856Sim.h"
+
+#include <stdlib.h>
+#include <chrono>
+
+#define MAX31856_BENCH_TICK_MICROS		500		//Loop period, how often DRDY is looked at
+#define MAX31856_BENCH_NOISE_SAMPLES	400
+#define MAX31856_BENCH_STEPS			16
+#define MAX31856_BENCH_SMALL_STEPS		64
+#define MAX31856_BENCH_STEP_MICROS		20000000
+#define MAX31856_BENCH_STEP_SAMPLES		256		//Response samples kept per step
+#define MAX31856_BENCH_SMALL_STEP		2.5		//Small step, in standard deviations of one conversion
+#define MAX31856_BENCH_RAMP				1.0		//C/s
+#define MAX31856_BENCH_RAMP_SAMPLES		256
+
+struct MAX31856Bench_Struct {
+	const char * Name;
+	uint8_t MedianN;
+	uint8_t EMAShift;
+	uint16_t KalmanQ;			//KalmanR comes from the noise at the AVGSEL being run
+};
+const struct MAX31856Bench_Struct MAX31856Benches[] = {
+	{ "none",				0, 0, 0 },
+	{ "median 3",			3, 0, 0 },
+	{ "median 5",			5, 0, 0 },
+	{ "EMA 1/4",			0, 2, 0 },
+	{ "EMA 1/8",			0, 3, 0 },
+	{ "median 3 + EMA 1/4",	3, 2, 0 },
+	{ "Kalman",				0, 0, 2 },
+	{ "median 3 + Kalman",	3, 0, 2 },
+};
+
+MAX31856Sim_Struct MAX31856BenchSim;
+MAX31856_Device_Struct MAX31856BenchTC;
+double MAX31856BenchRampRate = 0.0;		//C/s the hot junction is moving at, 0 for a constant temperature
+double MAX31856BenchRampFrom;
+uint32_t MAX31856BenchRampMicros;
+
+/*
+Wait for the next conversion and return it filtered
+*/
+int32_t MAX31856BenchNext(struct MAX31856_Filter_Struct * F) {
+	while (!MAX31856DataReady(&MAX31856BenchTC)) {
+		MAX31856HostAdvanceMicros(MAX31856_BENCH_TICK_MICROS);
+		if (MAX31856BenchRampRate != 0.0) {
+			MAX31856BenchSim.Temperature = MAX31856BenchRampFrom + MAX31856BenchRampRate * double(micros() - MAX31856BenchRampMicros) * 1.0E-6;
+		}
+		MAX31856SimUpdateAll();
+	}
+	MAX31856ReadTemperature(&MAX31856BenchTC);
+	return MAX31856FilterUpdate(F, MAX31856DecodeLTC(&MAX31856BenchTC.M.REG));
+} //===============================================================================================
+
+/*
+Steps of Size C, alternating up and down from where the temperature is, and the time the mean response takes to reach 90%
+*/
+double MAX31856BenchT90(struct MAX31856_Filter_Struct * F, double Size, uint8_t Steps) {
+	static double Fraction[MAX31856_BENCH_STEP_SAMPLES];
+	static double Millis[MAX31856_BENCH_STEP_SAMPLES];
+	uint16_t Samples = MAX31856_BENCH_STEP_SAMPLES;
+	memset(Fraction, 0, sizeof(Fraction));
+	memset(Millis, 0, sizeof(Millis));
+	double Base = MAX31856BenchSim.Temperature;
+	for (uint8_t s = 0; s < Steps; s++) {
+		double From = MAX31856BenchSim.Temperature;
+		double To = (s & 1) ? Base : Base + Size;
+		MAX31856HostAdvanceMicros(uint32_t(s) * 37 % 101 * 1000); //Move the step around within a conversion
+		MAX31856BenchSim.Temperature = To;
+		uint32_t StepMicros = micros();
+		uint16_t k = 0;
+		while (uint32_t(micros() - StepMicros) < MAX31856_BENCH_STEP_MICROS) {
+			double C = MAX31856LTCToDouble(MAX31856BenchNext(F));
+			if (k < MAX31856_BENCH_STEP_SAMPLES) {
+				Fraction[k] += (C - From) / (To - From);
+				Millis[k] += double(micros() - StepMicros) / 1000.0;
+				k++;
+			}
+		}
+		if (k < Samples) Samples = k; //Only as far as every step got
+	}
+	for (uint16_t k = 0; k < Samples; k++) {
+		if (Fraction[k] / Steps >= 0.9) return Millis[k] / Steps;
+	}
+	return MAX31856_BENCH_STEP_MICROS / 1000.0;
+} //===============================================================================================
+
+/*
+Mean time the output trails a ramp of MAX31856_BENCH_RAMP C/s by, ms
+*/
+double MAX31856BenchRampLag(struct MAX31856_Filter_Struct * F) {
+	MAX31856BenchRampFrom = MAX31856BenchSim.Temperature;
+	MAX31856BenchRampMicros = micros();
+	MAX31856BenchRampRate = MAX31856_BENCH_RAMP;
+	for (uint8_t i = 0; i < 64; i++) MAX31856BenchNext(F);
+	double Sum = 0;
+	for (uint16_t i = 0; i < MAX31856_BENCH_RAMP_SAMPLES; i++) {
+		double C = MAX31856LTCToDouble(MAX31856BenchNext(F));
+		Sum += (MAX31856BenchSim.Temperature - C) / MAX31856_BENCH_RAMP;
+	}
+	MAX31856BenchRampRate = 0.0;
+	return Sum * 1000.0 / MAX31856_BENCH_RAMP_SAMPLES;
+} //===============================================================================================
+
+double MAX31856BenchNanosPerSample(struct MAX31856_Filter_Struct * F) {
+	const uint32_t Count = 4000000;
+	uint32_t Seed = 1;
+	int32_t Sink = 0;
+	double Start = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	for (uint32_t i = 0; i < Count; i++) {
+		Seed = Seed * 1103515245 + 12345;
+		Sink += MAX31856FilterUpdate(F, 12800 + int32_t((Seed >> 16) & 0x3F) - 32);
+	}
+	double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count() - Start;
+	if (Sink == 0x7FFFFFFF) printf(" "); //Keeps the loop from being optimized away
+	return Elapsed * 1e9 / double(Count);
+} //===============================================================================================
+
+int main(int argc, char ** argv) {
+	double NoiseC = (argc > 1) ? atof(argv[1]) : 0.2;
+
+	printf("Single conversion noise %.3fC, 60Hz notch, automatic conversion\n\n", NoiseC);
+	printf("%-6s %-20s %9s %9s %9s %9s %9s %10s\n", "AVGSEL", "Filter", "Tconv ms", "Noise C", "T90 ms", "T90 small", "Ramp lag",
+		"ns/Sample");
+	for (uint8_t AVGSEL = 0; AVGSEL <= 4; AVGSEL++) {
+		for (uint8_t b = 0; b < sizeof(MAX31856Benches) / sizeof(MAX31856Benches[0]); b++) {
+			const struct MAX31856Bench_Struct * Bench = &MAX31856Benches[b];
+			MAX31856SimBegin(&MAX31856BenchSim, 10, 20);
+			MAX31856BenchSim.NoiseC = NoiseC;
+			MAX31856BenchSim.Temperature = 100.0;
+			MAX31856SimAttach(&MAX31856BenchSim, 1);
+			MAX31856Begin(&MAX31856BenchTC, 10, 20);
+			MAX31856BenchTC.M.REG.CR0.CMODE = true;
+			MAX31856BenchTC.M.REG.CR1.TCTYPE = 3;
+			MAX31856BenchTC.M.REG.CR1.AVGSEL = AVGSEL;
+			MAX31856BenchTC.M.REG.LTHFT.LTHFT = 0x7FFF;
+			MAX31856BenchTC.M.REG.LTLFT.LTLFT = -0x8000;
+			MAX31856BenchTC.M.REG.CJHF = 127;
+			MAX31856BenchTC.M.REG.CJLF = -128;
+			MAX31856WriteRegisters(&MAX31856BenchTC);
+
+			float Tconv, TconvMax;
+			MAX31856ConversionTime(&Tconv, &TconvMax, &MAX31856BenchTC.M);
+			double Sigma = NoiseC * 128.0 / sqrt(double(MAX31856AveragedSamples(&MAX31856BenchTC.M)));
+			uint16_t KalmanR = uint16_t(fmin(Sigma * Sigma + 1.0, 65535.0));
+			struct MAX31856_Filter_Struct F;
+			MAX31856FilterBegin(&F, Bench->MedianN, Bench->EMAShift, Bench->KalmanQ, Bench->KalmanQ ? KalmanR : 0);
+
+			//Noise: settle, then the spread of the output around its own mean
+			for (uint8_t i = 0; i < 64; i++) MAX31856BenchNext(&F);
+			double Sum = 0, SumSquares = 0;
+			for (uint16_t i = 0; i < MAX31856_BENCH_NOISE_SAMPLES; i++) {
+				double C = MAX31856LTCToDouble(MAX31856BenchNext(&F));
+				Sum += C;
+				SumSquares += C * C;
+			}
+			double Mean = Sum / MAX31856_BENCH_NOISE_SAMPLES;
+			double Noise = sqrt(fmax(SumSquares / MAX31856_BENCH_NOISE_SAMPLES - Mean * Mean, 0.0));
+
+			//Latency: alternate 100C and 110C, then steps of a few sigma, then a ramp
+			double T90 = MAX31856BenchT90(&F, 10.0, MAX31856_BENCH_STEPS);
+			double T90Small = MAX31856BenchT90(&F, MAX31856_BENCH_SMALL_STEP * Sigma / 128.0, MAX31856_BENCH_SMALL_STEPS);
+			double RampLag = MAX31856BenchRampLag(&F);
+
+			printf("%-6u %-20s %9.1f %9.4f %9.0f %9.0f %9.0f %10.1f\n", AVGSEL, Bench->Name, Tconv, Noise, T90, T90Small, RampLag,
+				MAX31856BenchNanosPerSample(&F));
+		}
+		printf("\n");
+	}
+	return 0;
+} //===============================================================================================
@@ -0,0 +1,202 @@
+/*
+Host (Linux/macOS) build support for MAX31856.h
+GitHub.com/TerryJMyers
+
+Just enough of the Arduino core for MAX31856.h to compile and run on a PC, so the decode, write and formatting logic can be
+exercised and timed off-target.  Together with MAX31856Sim.h this gives a deterministic harness with no hardware.
+Nothing here talks to real SPI, MAX31856Transport has to be pointed at the simulator (or your own driver).
+
+Time is simulated: micros()/millis() only move when MAX31856HostAdvanceMicros() is called or the simulator clocks SPI bytes,
+so runs are repeatable on any machine.
+
+Usage:
+	#include "extras/host/MAX31856Host.h"	//In place of Arduino.h and SPI.h
+	#include "MAX31856.h"
+	#include "extras/host/MAX31856Sim.h"
+
+	g++ -std=gnu++11 -O2 -I. my_host_program.cpp
+*/
+#ifndef MAX31856_HOST_H
+#define MAX31856_HOST_H
+
+#define MAX31856_HOST
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+
+//Flash strings are ordinary strings on a PC
+class __FlashStringHelper;
+#define F(s)				(reinterpret_cast<const __FlashStringHelper *>(s))
+#define PROGMEM
+#define PGM_P				const char *
+#define PSTR(s)				(s)
+#define pgm_read_byte(p)	(*(const uint8_t *)(p))
+#define pgm_read_word(p)	(*(const uint16_t *)(p))
+#define pgm_read_dword(p)	(*(const uint32_t *)(p))
+#define memcpy_P			memcpy
+#define strlen_P			strlen
+
+#define HIGH			1
+#define LOW				0
+#define INPUT			0
+#define OUTPUT			1
+#define INPUT_PULLUP	2
+#define DEC				10
+#define HEX				16
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+//Simulated clock, in ns so SPI byte times at MHz clocks do not round away
+uint64_t MAX31856HostNanos = 0;
+void MAX31856HostAdvanceMicros(uint32_t Micros) {
+	MAX31856HostNanos += uint64_t(Micros) * 1000;
+} //===============================================================================================
+uint32_t micros() {
+	return uint32_t(MAX31856HostNanos / 1000);
+} //===============================================================================================
+uint32_t millis() {
+	return uint32_t(MAX31856HostNanos / 1000000);
+} //===============================================================================================
+void delay(uint32_t ms) {
+	MAX31856HostAdvanceMicros(ms * 1000);
+} //===============================================================================================
+void delayMicroseconds(uint32_t us) {
+	MAX31856HostAdvanceMicros(us);
+} //===============================================================================================
+
+//GPIO.  Reads go through MAX31856HostDigitalRead so the simulator can drive DRDY, unhooked pins read HIGH
+int (*MAX31856HostDigitalRead)(uint8_t Pin) = NULL;
+void pinMode(uint8_t Pin, uint8_t Mode) {
+	(void)Pin; (void)Mode;
+} //===============================================================================================
+void digitalWrite(uint8_t Pin, uint8_t Value) {
+	(void)Pin; (void)Value;
+} //===============================================================================================
+int digitalRead(uint8_t Pin) {
+	if (MAX31856HostDigitalRead) return MAX31856HostDigitalRead(Pin);
+	return HIGH;
+} //===============================================================================================
+/*
+Interrupts.  A host program that emulates ISRs points MAX31856HostInterrupts at its dispatcher, which then runs whenever
+interrupts are enabled again, as a pending interrupt would fire on the chip.  A spin on a flag set from an ISR (e.g.
+MAX31856BusClaim()) re-enables interrupts on every pass, so the dispatcher also has to let simulated time move on
+*/
+void (*MAX31856HostInterrupts)() = NULL;
+bool MAX31856HostInterruptsEnabled = true;
+void noInterrupts() {
+	MAX31856HostInterruptsEnabled = false;
+} //===============================================================================================
+void interrupts() {
+	MAX31856HostInterruptsEnabled = true;
+	if (MAX31856HostInterrupts) MAX31856HostInterrupts();
+} //===============================================================================================
+
+char * dtostrf(double Value, signed char Width, unsigned char Decimals, char * Buffer) {
+	sprintf(Buffer, "%*.*f", Width, Decimals, Value);
+	return Buffer;
+} //===============================================================================================
+
+/*
+The parts of the Arduino Print class used by MAX31856.h
+*/
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t * Buffer, size_t Size) {
+		size_t n = 0;
+		while (Size--) n += write(*Buffer++);
+		return n;
+	}
+	size_t write(const char * s) { return write((const uint8_t *)s, strlen(s)); }
+	size_t print(const __FlashStringHelper * s) { return write((const char *)s); }
+	size_t print(const char * s) { return write(s); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char n, int Base = DEC) { return print((unsigned long)n, Base); }
+	size_t print(int n, int Base = DEC) { return print((long)n, Base); }
+	size_t print(unsigned int n, int Base = DEC) { return print((unsigned long)n, Base); }
+	size_t print(long n, int Base = DEC) {
+		if (Base == DEC || n >= 0) {
+			char Buffer[24];
+			sprintf(Buffer, Base == HEX ? "%lX" : "%ld", n);
+			return write(Buffer);
+		}
+		return print((unsigned long)n, Base);
+	}
+	size_t print(unsigned long n, int Base = DEC) {
+		char Buffer[24];
+		sprintf(Buffer, Base == HEX ? "%lX" : "%lu", n);
+		return write(Buffer);
+	}
+	size_t print(double n, int Digits = 2) {
+		char Buffer[48];
+		sprintf(Buffer, "%.*f", Digits, n);
+		return write(Buffer);
+	}
+	size_t println() { return write("\r\n"); }
+	template <typename T> size_t println(T Value) { size_t n = print(Value); return n + println(); }
+	template <typename T> size_t println(T Value, int Format) { size_t n = print(Value, Format); return n + println(); }
+};
+
+/*
+Print to stdout, stands in for Serial
+*/
+class MAX31856HostSerial : public Print {
+public:
+	using Print::write;
+	size_t write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+	size_t write(const uint8_t * Buffer, size_t Size) { return fwrite(Buffer, 1, Size, stdout); }
+};
+MAX31856HostSerial Serial;
+
+/*
+The parts of the Arduino String class used by MAX31856.h.
+MAX31856HostStringAllocations counts the heap allocations the Arduino String would make for the same calls: its WString
+mallocs on the first content and reallocs to exactly the length needed whenever it runs out of room
+*/
+uint32_t MAX31856HostStringAllocations = 0;
+class String {
+public:
+	std::string s;
+	unsigned int Capacity = 0;
+	bool Allocated = false;
+	void Need(size_t Length) {
+		if (Allocated && Length <= Capacity) return;
+		MAX31856HostStringAllocations++;
+		Allocated = true;
+		Capacity = (unsigned int)Length;
+	}
+	String() {}
+	String(const String & Other) : s(Other.s) { if (Other.Allocated) Need(s.length()); }
+	String(const char * c) : s(c) { Need(s.length()); }
+	String(const __FlashStringHelper * c) : s((const char *)c) { Need(s.length()); }
+	String(int n, unsigned char Base = DEC) { char Buffer[24]; sprintf(Buffer, Base == HEX ? "%x" : "%d", n); s = Buffer; Need(s.length()); }
+	String(unsigned char n, unsigned char Base = DEC) { char Buffer[24]; sprintf(Buffer, Base == HEX ? "%x" : "%u", n); s = Buffer; Need(s.length()); }
+	String(unsigned int n, unsigned char Base = DEC) { char Buffer[24]; sprintf(Buffer, Base == HEX ? "%x" : "%u", n); s = Buffer; Need(s.length()); }
+	String(long n, unsigned char Base = DEC) { char Buffer[24]; sprintf(Buffer, Base == HEX ? "%lx" : "%ld", n); s = Buffer; Need(s.length()); }
+	String(unsigned long n, unsigned char Base = DEC) { char Buffer[24]; sprintf(Buffer, Base == HEX ? "%lx" : "%lu", n); s = Buffer; Need(s.length()); }
+	String(float n, unsigned char Decimals = 2) { char Buffer[48]; s = dtostrf(n, Decimals + 2, Decimals, Buffer); Need(s.length()); }
+	String(double n, unsigned char Decimals = 2) { char Buffer[48]; s = dtostrf(n, Decimals + 2, Decimals, Buffer); Need(s.length()); }
+	String & operator = (const String & Other) { s = Other.s; Need(s.length()); return *this; }
+	unsigned int length() const { return s.length(); }
+	bool reserve(unsigned int Size) { s.reserve(Size); Need(Size); return true; }
+	const char * c_str() const { return s.c_str(); }
+	String & operator += (const String & Other) { Need(s.length() + Other.s.length()); s += Other.s; return *this; }
+	String & operator += (const char * c) { Need(s.length() + strlen(c)); s += c; return *this; }
+	String & operator += (const __FlashStringHelper * c) { Need(s.length() + strlen((const char *)c)); s += (const char *)c; return *this; }
+	String & operator += (char c) { Need(s.length() + 1); s += c; return *this; }
+	String & operator += (unsigned char n) { return *this += String(n); }
+	String & operator += (int n) { return *this += String(n); }
+	String & operator += (unsigned int n) { return *this += String(n); }
+	String & operator += (long n) { return *this += String(n); }
+	String & operator += (unsigned long n) { return *this += String(n); }
+	String & operator += (float n) { return *this += String(n); }
+	String & operator += (double n) { return *this += String(n); }
+};
+
+#endif
@@ -0,0 +1,115 @@
+/*
+MAX31856PollService() against the simulator, for boards without a DRDY line
+GitHub.com/TerryJMyers
+
+Runs a simulated MAX31856 with no DRDY pin and a main loop that calls MAX31856PollService() every MAX31856_CHECK_LOOP_MICROS,
+for every AVGSEL setting in automatic conversion and for one shots, with the simulated oscillator 5% slow, on time and 5% fast
+(Sim.ClockScale 1.05, 1.00, 0.95) and two levels of noise on the input.  Without DRDY a conversion is only seen by its result
+changing, so a perfectly steady input has no edges to time and is left out: the scheduler then falls back on taking a repeat
+after MAX31856_POLL_RETRIES late reads.  After MAX31856_CHECK_SETTLE_MICROS it prints:
+	Reads/conv	reads issued per conversion the device made, the scheduler aims for 1
+	Missed		automatic conversions overwritten before they were read
+	Stale		times MAX31856PollService() returned true for a conversion that had already been read
+	Period		the measured conversion time against the true one of the simulator, automatic conversion only
+	Lag ms		mean and worst time from the end of a conversion to the read that took it
+and fails the row if Reads/conv is over MAX31856_CHECK_MAX_READS, anything was missed or stale, the period is more than 1%
+out or the mean lag is over 1/8 of the conversion time.  Exits with 1 if any row failed.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856PollCheck extras/host/MAX31856PollCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856Sim.h"
+
+#define MAX31856_CHECK_RUN_MICROS		60000000	//Simulated time per row
+#define MAX31856_CHECK_SETTLE_MICROS	5000000		//Left out of the figures while the period estimate settles
+#define MAX31856_CHECK_LOOP_MICROS		50			//Main loop pass
+#define MAX31856_CHECK_MAX_READS		1.25
+
+MAX31856Sim_Struct MAX31856CheckSim;
+MAX31856_Device_Struct MAX31856CheckTC;
+
+bool MAX31856CheckRun(bool OneShot, uint8_t AVGSEL, double ClockScale, double NoiseC) {
+	MAX31856HostNanos += 1000000000ull; //Each row starts from its own point in time
+	MAX31856SimBegin(&MAX31856CheckSim, 10);
+	MAX31856CheckSim.Temperature = 100.0;
+	MAX31856CheckSim.ClockScale = ClockScale;
+	MAX31856CheckSim.NoiseC = NoiseC;
+	MAX31856SimAttach(&MAX31856CheckSim, 1);
+	MAX31856Begin(&MAX31856CheckTC, 10);
+	MAX31856CheckTC.M.REG.CR0.CMODE = !OneShot;
+	MAX31856CheckTC.M.REG.CR1.TCTYPE = 3;
+	MAX31856CheckTC.M.REG.CR1.AVGSEL = AVGSEL;
+	MAX31856WriteRegisters(&MAX31856CheckTC);
+
+	struct MAX31856_Poll_Struct Poll;
+	MAX31856PollBegin(&Poll, &MAX31856CheckTC);
+	if (OneShot) MAX31856PollOneShot(&Poll);
+
+	uint32_t StartMicros = micros();
+	bool Settled = false;
+	uint32_t Reads = 0, Conversions = 0, Missed = 0, Stale = 0, Taken = 0, LastTaken = 0;
+	double LagSum = 0.0, LagMax = 0.0;
+	uint64_t Period = MAX31856SimConversionNanos(&MAX31856CheckSim);
+	while (micros() - StartMicros < MAX31856_CHECK_RUN_MICROS) {
+		if (!Settled && micros() - StartMicros >= MAX31856_CHECK_SETTLE_MICROS) {
+			Settled = true;
+			MAX31856SimUpdate(&MAX31856CheckSim);
+			Reads = Poll.Reads;
+			Conversions = MAX31856CheckSim.Conversions;
+			Missed = MAX31856CheckSim.Missed;
+		}
+		if (MAX31856PollService(&Poll)) {
+			//The read has brought the simulator up to date, so it knows which conversion that was and when it ended
+			uint32_t Conversion = MAX31856CheckSim.Conversions;
+			uint64_t DoneNanos = MAX31856CheckSim.DoneNanos;
+			if (!OneShot) DoneNanos -= Period; //Already on the next one
+			if (Settled) {
+				if (Conversion == LastTaken) Stale++;
+				double Lag = double(MAX31856HostNanos - DoneNanos) * 1.0E-6;
+				LagSum += Lag;
+				if (Lag > LagMax) LagMax = Lag;
+				Taken++;
+			}
+			LastTaken = Conversion;
+			if (OneShot) MAX31856PollOneShot(&Poll);
+		}
+		MAX31856HostAdvanceMicros(MAX31856_CHECK_LOOP_MICROS);
+	}
+	MAX31856SimUpdate(&MAX31856CheckSim);
+	Reads = Poll.Reads - Reads;
+	Conversions = MAX31856CheckSim.Conversions - Conversions;
+	Missed = MAX31856CheckSim.Missed - Missed;
+
+	double ReadsPerConversion = Conversions ? double(Reads) / double(Conversions) : 0.0;
+	double PeriodError = OneShot ? 0.0 : 100.0 * (double(Poll.PeriodMicros) * 1000.0 - double(Period)) / double(Period);
+	double LagMean = Taken ? LagSum / double(Taken) : 0.0;
+	bool Pass = Conversions != 0 && ReadsPerConversion <= MAX31856_CHECK_MAX_READS && Missed == 0 && Stale == 0 &&
+		fabs(PeriodError) <= 1.0 && LagMean <= double(Period) * 1.0E-6 / 8.0;
+	printf("%-8s %6u %6.2f %5.2f %9.3f %6lu %6lu %6lu %+8.2f%% %8.2f %8.2f %5s\n", OneShot ? "OneShot" : "Auto", AVGSEL, ClockScale,
+		NoiseC, ReadsPerConversion, (unsigned long)Conversions, (unsigned long)Missed, (unsigned long)Stale, PeriodError, LagMean,
+		LagMax, Pass ? "ok" : "FAIL");
+	return Pass;
+} //===============================================================================================
+
+int main() {
+	const double ClockScales[] = { 1.05, 1.00, 0.95 };
+	const double Noises[] = { 0.25, 1.0 };
+	bool Pass = true;
+
+	printf("%-8s %6s %6s %5s %9s %6s %6s %6s %9s %8s %8s %5s\n", "Mode", "AVGSEL", "Clock", "Noise", "Reads/conv", "Conv", "Missed",
+		"Stale", "Period", "Lag ms", "Max ms", "");
+	for (uint8_t n = 0; n < sizeof(Noises) / sizeof(Noises[0]); n++) {
+		for (uint8_t c = 0; c < sizeof(ClockScales) / sizeof(ClockScales[0]); c++) {
+			for (uint8_t AVGSEL = 0; AVGSEL <= 4; AVGSEL++) {
+				if (!MAX31856CheckRun(false, AVGSEL, ClockScales[c], Noises[n])) Pass = false;
+			}
+			if (!MAX31856CheckRun(true, 0, ClockScales[c], Noises[n])) Pass = false;
+			if (!MAX31856CheckRun(true, 2, ClockScales[c], Noises[n])) Pass = false;
+		}
+	}
+
+	printf("\n%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================
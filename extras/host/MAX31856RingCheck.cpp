@@ -0,0 +1,173 @@
+/*
+MAX31856_Ring_Struct and MAX31856_Stats_Struct against reference implementations
+GitHub.com/TerryJMyers
+
+Ring: pushes and pops in bursts of varying size for MAX31856_CHECK_RING_PUSHES samples, well past the 256 where the free
+running uint8_t Head and Tail wrap, with the ring driven into overrun on every other burst.  A plain queue of what was
+accepted is kept alongside, and every pop has to come back in order and intact, MAX31856RingCount() has to match the queue
+and Overruns has to equal the pushes MAX31856RingPush() turned away.
+Stats: feeds the same stream of samples to MAX31856StatsAdd() and to a double precision reference that keeps every sample
+(two pass mean and variance, min/max, the rate between the last two samples and the window of the last
+MAX31856_STATS_WINDOW), then compares them at every sample and prints the worst difference of each figure for:
+	steady		300C with 0.2C of noise
+	ramp		25C to 1000C over the run, far from the first sample the sums are taken relative to
+	wrap		steady, with micros() wrapping through 0 partway
+	step		a step of 500C halfway, the variance jumps by orders of magnitude
+Min/Max and the window average have to be exact, the rates within MAX31856_CHECK_RATE_TOLERANCE of the reference and the
+mean and standard deviation within MAX31856_CHECK_TOLERANCE C.  Exits with 1 if anything failed.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856RingCheck extras/host/MAX31856RingCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+
+#include <deque>
+#include <vector>
+
+#define MAX31856_CHECK_RING_PUSHES		100000
+#define MAX31856_CHECK_STATS_SAMPLES	100000		//About 2 hours at AVGSEL 0
+#define MAX31856_CHECK_PERIOD_MICROS	82000
+#define MAX31856_CHECK_TOLERANCE		0.001		//C, mean and standard deviation
+#define MAX31856_CHECK_RATE_TOLERANCE	1.0E-4		//Relative, rates
+
+uint32_t MAX31856CheckSeed = 0x31856u;
+uint32_t MAX31856CheckRandom() {
+	MAX31856CheckSeed = MAX31856CheckSeed * 1664525u + 1013904223u;
+	return MAX31856CheckSeed >> 8;
+} //===============================================================================================
+double MAX31856CheckGaussian() { //Irwin-Hall approximation, mean 0 standard deviation 1
+	double Sum = 0.0;
+	for (uint8_t i = 0; i < 12; i++) Sum += double(MAX31856CheckRandom()) / 16777216.0;
+	return Sum - 6.0;
+} //===============================================================================================
+
+bool MAX31856CheckRing() {
+	MAX31856_Ring_Struct Ring;
+	memset((void *)&Ring, 0, sizeof(Ring));
+	std::deque<MAX31856_Sample_Struct> Reference;
+	uint32_t Pushes = 0, Rejected = 0, Pops = 0, Wrong = 0;
+	uint8_t Burst = 0;
+	while (Pushes < MAX31856_CHECK_RING_PUSHES) {
+		//Every other burst pushes more than the ring holds
+		uint32_t In = (Burst & 1) ? MAX31856_RING_SIZE + 1 + MAX31856CheckRandom() % MAX31856_RING_SIZE : MAX31856CheckRandom() % MAX31856_RING_SIZE;
+		uint32_t Out = MAX31856CheckRandom() % (MAX31856_RING_SIZE + 2);
+		Burst++;
+		for (uint32_t i = 0; i < In; i++) {
+			MAX31856_Fixed_Struct T;
+			T.LTC = int32_t(Pushes * 7919u % 262144u) - 131072;
+			T.CJT = int16_t(Pushes * 31u);
+			T.SR = uint8_t(Pushes);
+			bool Full = Reference.size() >= MAX31856_RING_SIZE;
+			if (MAX31856RingPush(&Ring, &T, uint8_t(Pushes >> 8), Pushes * 1000u) == Full) Wrong++;
+			if (Full) Rejected++;
+			else {
+				MAX31856_Sample_Struct S = { Pushes * 1000u, T.LTC, T.CJT, T.SR, uint8_t(Pushes >> 8) };
+				Reference.push_back(S);
+			}
+			Pushes++;
+		}
+		for (uint32_t i = 0; i < Out; i++) {
+			MAX31856_Sample_Struct S;
+			bool Popped = MAX31856RingPop(&Ring, &S);
+			if (Popped != !Reference.empty()) Wrong++;
+			if (!Popped) break;
+			const MAX31856_Sample_Struct & R = Reference.front();
+			if (S.Micros != R.Micros || S.LTC != R.LTC || S.CJT != R.CJT || S.SR != R.SR || S.Device != R.Device) Wrong++;
+			Reference.pop_front();
+			Pops++;
+		}
+		if (MAX31856RingCount(&Ring) != Reference.size()) Wrong++;
+	}
+	bool Pass = Wrong == 0 && Ring.Overruns == Rejected && Rejected != 0 && Pops > 256;
+	printf("%-8s %8lu %8lu %9lu %6lu %5s\n\n", "ring", (unsigned long)Pushes, (unsigned long)Pops, (unsigned long)Ring.Overruns,
+		(unsigned long)Wrong, Pass ? "ok" : "FAIL");
+	return Pass;
+} //===============================================================================================
+
+/*
+Largest difference seen for each figure over a run
+*/
+struct MAX31856CheckWorst_Struct {
+	uint32_t MinMax;
+	double Mean;
+	double StdDev;
+	double Rate;
+	double WindowAverage;
+	double WindowRate;
+};
+void MAX31856CheckWorst(double * Worst, double Difference) {
+	if (fabs(Difference) > *Worst) *Worst = fabs(Difference);
+} //===============================================================================================
+double MAX31856CheckRelative(double Value, double Reference) {
+	return (Value - Reference) / (fabs(Reference) > 1.0 ? fabs(Reference) : 1.0);
+} //===============================================================================================
+
+bool MAX31856CheckStats(const char * Name, double From, double To, double Step, uint32_t StartMicros) {
+	MAX31856_Stats_Struct Stats;
+	MAX31856StatsReset(&Stats);
+	std::vector<MAX31856_Sample_Struct> Samples;
+	MAX31856CheckWorst_Struct Worst;
+	memset(&Worst, 0, sizeof(Worst));
+	double Sum = 0.0;
+	int32_t Min = 0, Max = 0;
+	for (uint32_t n = 0; n < MAX31856_CHECK_STATS_SAMPLES; n++) {
+		double C = From + (To - From) * double(n) / double(MAX31856_CHECK_STATS_SAMPLES) + 0.2 * MAX31856CheckGaussian();
+		if (n >= MAX31856_CHECK_STATS_SAMPLES / 2) C += Step;
+		//A little jitter on the read times so the rates are not all the same division
+		uint32_t Micros = StartMicros + n * MAX31856_CHECK_PERIOD_MICROS + MAX31856CheckRandom() % 1000;
+		MAX31856_Sample_Struct S = { Micros, int32_t(lround(C * 128.0)), 0, 0, 0 };
+		MAX31856StatsAdd(&Stats, &S);
+		Samples.push_back(S);
+
+		Sum += MAX31856LTCToDouble(S.LTC);
+		if (n == 0 || S.LTC < Min) Min = S.LTC;
+		if (n == 0 || S.LTC > Max) Max = S.LTC;
+		if (Stats.Min != Min || Stats.Max != Max) Worst.MinMax++;
+		double Mean = Sum / double(n + 1);
+		MAX31856CheckWorst(&Worst.Mean, MAX31856StatsMean(&Stats) - Mean);
+		if (n > 0) {
+			const MAX31856_Sample_Struct & P = Samples[n - 1];
+			double Rate = MAX31856LTCToDouble(S.LTC - P.LTC) * 1.0E6 / double(uint32_t(S.Micros - P.Micros));
+			MAX31856CheckWorst(&Worst.Rate, MAX31856CheckRelative(Stats.Rate, Rate));
+		}
+
+		uint32_t Window = n + 1 < MAX31856_STATS_WINDOW ? n + 1 : MAX31856_STATS_WINDOW;
+		const MAX31856_Sample_Struct & Oldest = Samples[n + 1 - Window];
+		double WindowSum = 0.0;
+		for (uint32_t i = n + 1 - Window; i <= n; i++) WindowSum += MAX31856LTCToDouble(Samples[i].LTC);
+		MAX31856CheckWorst(&Worst.WindowAverage, MAX31856StatsWindowAverage(&Stats) - WindowSum / double(Window));
+		if (Window >= 2) {
+			double WindowRate = MAX31856LTCToDouble(S.LTC - Oldest.LTC) * 1.0E6 / double(uint32_t(S.Micros - Oldest.Micros));
+			MAX31856CheckWorst(&Worst.WindowRate, MAX31856CheckRelative(MAX31856StatsWindowRate(&Stats), WindowRate));
+		}
+
+		//The full two pass variance is only worth the time now and then
+		if ((n & 1023) == 1023 || n + 1 == MAX31856_CHECK_STATS_SAMPLES) {
+			double M2 = 0.0;
+			for (uint32_t i = 0; i <= n; i++) M2 += (MAX31856LTCToDouble(Samples[i].LTC) - Mean) * (MAX31856LTCToDouble(Samples[i].LTC) - Mean);
+			MAX31856CheckWorst(&Worst.StdDev, MAX31856StatsStdDev(&Stats) - sqrt(M2 / double(n)));
+		}
+	}
+	bool Pass = Stats.Count == MAX31856_CHECK_STATS_SAMPLES && Worst.MinMax == 0 && Worst.WindowAverage < 1.0E-9
+		&& Worst.Mean <= MAX31856_CHECK_TOLERANCE && Worst.StdDev <= MAX31856_CHECK_TOLERANCE
+		&& Worst.Rate <= MAX31856_CHECK_RATE_TOLERANCE && Worst.WindowRate <= MAX31856_CHECK_RATE_TOLERANCE;
+	printf("%-8s %7lu %10.2e %10.2e %10.2e %10.2e %10.2e %5s\n", Name, (unsigned long)Worst.MinMax, Worst.Mean, Worst.StdDev,
+		Worst.Rate, Worst.WindowAverage, Worst.WindowRate, Pass ? "ok" : "FAIL");
+	return Pass;
+} //===============================================================================================
+
+int main() {
+	bool Pass = true;
+	printf("%-8s %8s %8s %9s %6s\n", "", "Pushes", "Pops", "Overruns", "Wrong");
+	Pass &= MAX31856CheckRing();
+
+	printf("%-8s %7s %10s %10s %10s %10s %10s\n", "Stats", "MinMax", "Mean C", "StdDev C", "Rate", "Window C", "Window rate");
+	Pass &= MAX31856CheckStats("steady", 300.0, 300.0, 0.0, 0);
+	Pass &= MAX31856CheckStats("ramp", 25.0, 1000.0, 0.0, 0);
+	Pass &= MAX31856CheckStats("wrap", 300.0, 300.0, 0.0, 0xFFFFFFFFu - 50u * MAX31856_CHECK_PERIOD_MICROS);
+	Pass &= MAX31856CheckStats("step", 25.0, 25.0, 500.0, 0);
+
+	printf("\n%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================
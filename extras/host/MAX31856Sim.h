@@ -0,0 +1,282 @@
+/*
+Simulated MAX31856 for host builds
+GitHub.com/TerryJMyers
+
+A register level model of the MAX31856 sitting behind MAX31856Transport, so everything in MAX31856.h can run against it
+with no hardware:
+	- 16 byte register file with the power on defaults, auto incrementing addresses that wrap at 0x0F
+	- 0x0C-0x0F (LTC and SR) are read only, writes to them are dropped
+	- Conversions take the typical time from MAX31856ConversionTime() for the current CR0.CMODE, CR0.Hz50_60 and CR1.AVGSEL,
+	  back to back in automatic mode, one per CR0.ONESHOT write otherwise (ONESHOT reads back 1 until it completes).  The
+	  first automatic conversion after CMODE is set takes the one shot time
+	- DRDY goes low when a conversion completes and back high when any LTC byte is read
+	- SR threshold faults against LTHFT/LTLFT/CJHF/CJLF, latched in CR0.FAULT mode until FAULTCLR, plus injected faults
+	- Internal cold junction (with CJTO) or, with CR0.CJ set, the CJT value written by the host
+	- Voltage modes (TCTYPE 8-15) code InputVolts at 8x or 32x gain
+	- SPI time: every transfer advances the simulated clock by its byte time at MAX31856_SIM_SPI_HZ plus CS overhead
+Noise is a repeatable pseudo random Gaussian with NoiseC standard deviation per single sample, reduced by sqrt(averaged samples).
+
+Typical Use:
+	#include "extras/host/MAX31856Host.h"
+	#include "MAX31856.h"
+	#include "extras/host/MAX31856Sim.h"
+
+	MAX31856Sim_Struct Sim[4];
+	MAX31856_Device_Struct TC[4];
+
+	int main() {
+		for (uint8_t i = 0; i < 4; i++) {
+			MAX31856SimBegin(&Sim[i], 10 + i, 20 + i);	//CS pin, DRDY pin
+			Sim[i].Temperature = 100.0 + i;
+			MAX31856Begin(&TC[i], 10 + i, 20 + i);
+		}
+		MAX31856SimAttach(&Sim[0], 4);	//Points MAX31856Transport and digitalRead() at the simulators
+		...
+		Sim[2].InjectedFaults = 0x01;	//Open thermocouple from the next conversion on
+		MAX31856HostAdvanceMicros(100000);
+	}
+*/
+#ifndef MAX31856_SIM_H
+#define MAX31856_SIM_H
+
+#define MAX31856_SIM_SPI_HZ				5000000		//Matches MAX31856_SPISettings
+#define MAX31856_SIM_TRANSACTION_NANOS	1000		//CS setup/hold and transaction overhead per transfer
+
+struct MAX31856Sim_Struct {
+	uint8_t CSPin;				//MAX31856_NO_PIN to answer every transfer
+	uint8_t DRDYPin;			//MAX31856_NO_PIN if not wired
+	uint8_t Registers[16];
+	double Temperature;			//Hot junction, C
+	double CJTemperature;		//Actual cold junction, C
+	double InputVolts;			//Thermocouple input in the voltage modes
+	double NoiseC;				//Standard deviation of one unaveraged sample, C
+	double ClockScale;			//Conversion time relative to the datasheet typical, models the internal oscillator tolerance
+	uint8_t InjectedFaults;		//SR bits forced on at every conversion, e.g. 0x01 OPEN, 0x02 OVUV
+	bool Selected;				//Chip select currently low
+	uint8_t FrameAddress;		//Register the next byte of the current chip select frame goes to
+	bool FrameWrite;
+	bool DRDY;					//Pin level, LOW when a conversion is waiting
+	bool Converting;
+	uint64_t DoneNanos;			//When the conversion in progress completes
+	uint32_t Conversions;		//Conversions completed
+	uint32_t Missed;			//Automatic conversions overwritten before their LTC was read
+	uint32_t Seed;				//Noise generator state
+};
+
+struct MAX31856Sim_Struct * MAX31856SimDevices = NULL;
+uint8_t MAX31856SimNumDevices = 0;
+bool MAX31856SimFramed = false;	//The address byte of the current frame has gone out, later transfers in the frame carry data
+
+void MAX31856SimBegin(struct MAX31856Sim_Struct * S, uint8_t CSPin, uint8_t DRDYPin = MAX31856_NO_PIN) {
+	static const uint8_t Defaults[16] = { 0x00, 0x03, 0xff, 0x7f, 0xc0, 0x7f, 0xff, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+	memset((void *)S, 0, sizeof(struct MAX31856Sim_Struct));
+	memcpy(&S->Registers[0], &Defaults[0], sizeof(Defaults));
+	S->CSPin = CSPin;
+	S->DRDYPin = DRDYPin;
+	S->Temperature = 25.0;
+	S->CJTemperature = 25.0;
+	S->ClockScale = 1.0;
+	S->DRDY = HIGH;
+	S->Seed = 0x31856u + CSPin;
+} //===============================================================================================
+
+/*
+Register image of the simulator as a MAX31856_REG_Struct, used for MAX31856ConversionTime()
+*/
+void MAX31856SimImage(struct MAX31856Sim_Struct * S, struct MAX31856_REG_Struct * M) {
+	MAX31856UnpackRegisters(M, &S->Registers[0]);
+} //===============================================================================================
+uint64_t MAX31856SimConversionNanos(struct MAX31856Sim_Struct * S, bool First = false) {
+	struct MAX31856_REG_Struct M;
+	float Tconv, TconvMax;
+	MAX31856SimImage(S, &M);
+	if (First) M.REG.CR0.CMODE = false; //As long as a one shot
+	MAX31856ConversionTime(&Tconv, &TconvMax, &M);
+	return uint64_t(double(Tconv) * 1000000.0 * S->ClockScale);
+} //===============================================================================================
+
+double MAX31856SimGaussian(struct MAX31856Sim_Struct * S) { //Irwin-Hall approximation, mean 0 standard deviation 1
+	double Sum = 0.0;
+	for (uint8_t i = 0; i < 12; i++) {
+		S->Seed = S->Seed * 1664525u + 1013904223u;
+		Sum += double(S->Seed >> 8) / 16777216.0;
+	}
+	return Sum - 6.0;
+} //===============================================================================================
+
+/*
+Latch a finished conversion into LTC, CJT and SR
+*/
+void MAX31856SimComplete(struct MAX31856Sim_Struct * S) {
+	uint8_t * R = &S->Registers[0];
+	struct MAX31856_REG_Struct M;
+	MAX31856SimImage(S, &M);
+	double Noise = S->NoiseC * MAX31856SimGaussian(S) / sqrt(double(MAX31856AveragedSamples(&M)));
+
+	//Cold junction: measured by the internal sensor (14 bits, 1/64C) unless CR0.CJ disabled it
+	int32_t CJT;
+	if (!M.REG.CR0.CJ) {
+		CJT = int32_t(lround((S->CJTemperature + double(M.REG.CJTO) * 0.0625) * 64.0)) * 4;
+		if (CJT > 32767) CJT = 32764;
+		if (CJT < -32768) CJT = -32768;
+		R[10] = uint8_t(uint16_t(CJT) >> 8);
+		R[11] = uint8_t(CJT);
+	}
+	else {
+		CJT = M.REG.CJT.CJT;
+	}
+
+	int32_t Code;
+	if (M.REG.CR1.TCTYPE >= 8) {
+		double Gain = (M.REG.CR1.TCTYPE >= 12) ? 32.0 : 8.0;
+		Code = int32_t(lround((S->InputVolts + Noise * 0.00004) * Gain * 1.6 * 131072.0));
+	}
+	else {
+		//The chip compensates with the CJT register, so a wrong external CJ shows up one for one in LTC
+		double Reported = S->Temperature + Noise + double(CJT) * 0.00390625 - S->CJTemperature;
+		Code = int32_t(lround(Reported * 128.0));
+	}
+	if (Code > 262143) Code = 262143;
+	if (Code < -262144) Code = -262144;
+	uint32_t Raw = uint32_t(Code) << 5;
+	R[12] = uint8_t(Raw >> 16);
+	R[13] = uint8_t(Raw >> 8);
+	R[14] = uint8_t(Raw);
+
+	uint8_t SR = S->InjectedFaults;
+	if (Code > int32_t(M.REG.LTHFT.LTHFT) * 8) SR |= 0x08;	//TCHIGH
+	if (Code < int32_t(M.REG.LTLFT.LTLFT) * 8) SR |= 0x04;	//TCLOW
+	if (CJT > int32_t(M.REG.CJHF) * 256) SR |= 0x20;			//CJHIGH
+	if (CJT < int32_t(M.REG.CJLF) * 256) SR |= 0x10;			//CJLOW
+	if (M.REG.CR0.FAULT) R[15] |= SR;	//Interrupt mode, latched until FAULTCLR
+	else R[15] = SR;					//Comparator mode
+
+	if (S->DRDY == LOW) S->Missed++;
+	S->DRDY = LOW;
+	S->Conversions++;
+} //===============================================================================================
+
+/*
+Bring the simulator up to the current simulated time
+*/
+void MAX31856SimUpdate(struct MAX31856Sim_Struct * S) {
+	while (S->Converting && MAX31856HostNanos >= S->DoneNanos) {
+		MAX31856SimComplete(S);
+		if (S->Registers[0] & 0x80) { //CMODE, the next conversion starts straight away
+			uint64_t Period = MAX31856SimConversionNanos(S);
+			S->DoneNanos += Period;
+			if (MAX31856HostNanos >= S->DoneNanos + 4 * Period) { //Long idle, skip ahead rather than simulate every conversion
+				uint64_t Skip = (MAX31856HostNanos - S->DoneNanos) / Period;
+				S->DoneNanos += Skip * Period;
+				S->Conversions += uint32_t(Skip);
+				S->Missed += uint32_t(Skip);
+			}
+		}
+		else {
+			S->Registers[0] &= ~0x40; //ONESHOT reads back 0 once the conversion is done
+			S->Converting = false;
+		}
+	}
+} //===============================================================================================
+
+/*
+One register write, with the side effects of CR0
+*/
+void MAX31856SimWrite(struct MAX31856Sim_Struct * S, uint8_t Address, uint8_t Value) {
+	if (Address >= 0x0C) return; //LTC and SR are read only
+	if (Address != 0x00) {
+		S->Registers[Address] = Value;
+		return;
+	}
+	uint8_t Old = S->Registers[0];
+	if (Value & 0x02) S->Registers[15] = 0; //FAULTCLR
+	S->Registers[0] = Value & ~0x02;
+	if ((Value & 0x80) && !(Old & 0x80)) { //Automatic conversion turned on
+		S->Converting = true;
+		S->DoneNanos = MAX31856HostNanos + MAX31856SimConversionNanos(S, true);
+	}
+	else if (!(Value & 0x80)) {
+		if ((Value & 0x40) && !S->Converting) {
+			S->Converting = true;
+			S->DoneNanos = MAX31856HostNanos + MAX31856SimConversionNanos(S);
+		}
+		else if (!(Value & 0x40) && (Old & 0x80)) {
+			S->Converting = false; //Automatic conversion turned off
+		}
+		if (S->Converting) S->Registers[0] |= 0x40;
+	}
+} //===============================================================================================
+
+/*
+Part of a chip select framed transfer into a simulator, MISO bytes are ANDed into BufferIn so several selected devices behave
+like a wired bus.  The first byte of a frame is the address, a frame can be clocked out over several Transfer calls
+*/
+void MAX31856SimTransaction(struct MAX31856Sim_Struct * S, const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length) {
+	uint16_t i = 0;
+	if (Length > 0 && !MAX31856SimFramed) {
+		MAX31856SimUpdate(S);
+		S->FrameWrite = (BufferOut[0] & 0x80) != 0;
+		S->FrameAddress = BufferOut[0] & 0x0F;
+		i = 1;
+	}
+	for (; i < Length; i++) {
+		if (S->FrameWrite) MAX31856SimWrite(S, S->FrameAddress, BufferOut[i]);
+		else {
+			if (BufferIn) BufferIn[i] &= S->Registers[S->FrameAddress];
+			if (S->FrameAddress >= 0x0C && S->FrameAddress <= 0x0E) S->DRDY = HIGH;
+		}
+		S->FrameAddress = (S->FrameAddress + 1) & 0x0F;
+	}
+} //===============================================================================================
+
+void MAX31856SimTransportBegin() {
+	MAX31856SimFramed = false; //Devices with no chip select frame on the transaction
+} //===============================================================================================
+void MAX31856SimTransportEnd() {
+} //===============================================================================================
+void MAX31856SimSelect(uint8_t CSPin, bool Selected) {
+	for (uint8_t i = 0; i < MAX31856SimNumDevices; i++) {
+		if (MAX31856SimDevices[i].CSPin == CSPin) MAX31856SimDevices[i].Selected = Selected;
+	}
+	if (Selected) MAX31856SimFramed = false;
+} //===============================================================================================
+void MAX31856SimTransfer(const uint8_t * BufferOut, uint8_t * BufferIn, uint16_t Length) {
+	if (BufferIn) memset(BufferIn, 0xFF, Length); //Nothing driving MISO reads high
+	for (uint8_t i = 0; i < MAX31856SimNumDevices; i++) {
+		struct MAX31856Sim_Struct * S = &MAX31856SimDevices[i];
+		if (S->Selected || S->CSPin == MAX31856_NO_PIN) MAX31856SimTransaction(S, BufferOut, BufferIn, Length);
+	}
+	if (BufferIn && Length > 0 && !MAX31856SimFramed) BufferIn[0] = 0x00; //Address phase
+	if (Length > 0) MAX31856SimFramed = true;
+	MAX31856HostNanos += MAX31856_SIM_TRANSACTION_NANOS + uint64_t(Length) * 8 * 1000000000ull / MAX31856_SIM_SPI_HZ;
+} //===============================================================================================
+int MAX31856SimDigitalRead(uint8_t Pin) {
+	for (uint8_t i = 0; i < MAX31856SimNumDevices; i++) {
+		struct MAX31856Sim_Struct * S = &MAX31856SimDevices[i];
+		if (S->DRDYPin == Pin) {
+			MAX31856SimUpdate(S);
+			return S->DRDY;
+		}
+	}
+	return HIGH;
+} //===============================================================================================
+MAX31856_Transport_Struct MAX31856SimTransport = { MAX31856SimTransportBegin, MAX31856SimTransportEnd, MAX31856SimSelect, MAX31856SimTransfer, NULL };
+
+/*
+Put NumDevices simulators on the bus: MAX31856Transport and digitalRead() are pointed at them
+*/
+void MAX31856SimAttach(struct MAX31856Sim_Struct * Devices, uint8_t NumDevices) {
+	MAX31856SimDevices = Devices;
+	MAX31856SimNumDevices = NumDevices;
+	MAX31856Transport = &MAX31856SimTransport;
+	MAX31856HostDigitalRead = MAX31856SimDigitalRead;
+} //===============================================================================================
+
+/*
+Run every simulator up to the current simulated time, e.g. after MAX31856HostAdvanceMicros() when nothing has touched the bus
+*/
+void MAX31856SimUpdateAll() {
+	for (uint8_t i = 0; i < MAX31856SimNumDevices; i++) MAX31856SimUpdate(&MAX31856SimDevices[i]);
+} //===============================================================================================
+
+#endif
@@ -0,0 +1,113 @@
+/*
+Accuracy of the compile time type K tables (MAX31856TypeK) against the NIST ITS-90 type K polynomials
+GitHub.com/TerryJMyers
+
+Checks, over the whole range of each table segment:
+	TemperatureFromEMF	table inverse against the NIST reference function E(T), worst error in C
+	EMFFromTemperature	table EMF against E(T), worst error in uV
+	Linearize			cold junction compensated conversion for CJT -20C to 80C, worst error in C
+	Inverse				table inverse against the NIST inverse polynomial T(E) from -200C up, for reference only, the inverse
+						polynomial is itself only good to about 0.06C (NIST Monograph 175)
+E(T) is evaluated here from its own copy of the NIST coefficients at run time, not through MAX31856TypeKCurve.
+Exits with 1 if any limit in MAX31856TypeKLimits is exceeded.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856TypeKCheck extras/host/MAX31856TypeKCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+
+#define MAX31856_CHECK_STEP_C		0.01	//Temperature step of the sweeps
+#define MAX31856_CHECK_EMF_UV		1.0		//Interpolation across the 10C steps, the 1nV rounding of the entries is negligible
+#define MAX31856_CHECK_CJ_C			0.05
+
+struct MAX31856TypeKLimit_Struct {
+	double TMin;
+	double TMax;
+	double MaxErrorC;			//Stated in the MAX31856TypeKCurve comment
+};
+const struct MAX31856TypeKLimit_Struct MAX31856TypeKLimits[] = {
+	{ -270.0, -200.0, 0.04 },
+	{ -200.0, 0.0, 0.025 },
+	{ 0.0, 1372.0, 0.015 },
+};
+
+/*
+NIST ITS-90 type K reference function, mV
+*/
+double MAX31856NISTTypeK(double T) {
+	static const double Below[] = { 0.0, 0.394501280250E-01, 0.236223735980E-04, -0.328589067840E-06, -0.499048287770E-08,
+		-0.675090591730E-10, -0.574103274280E-12, -0.310888728940E-14, -0.104516093650E-16, -0.198892668780E-19, -0.163226974860E-22 };
+	static const double Above[] = { -0.176004136860E-01, 0.389212049750E-01, 0.185587700320E-04, -0.994575928740E-07,
+		0.318409457190E-09, -0.560728448890E-12, 0.560750590590E-15, -0.320207200030E-18, 0.971511471520E-22, -0.121047212750E-25 };
+	const double * c = (T < 0.0) ? Below : Above;
+	int n = (T < 0.0) ? 11 : 10;
+	double E = 0.0;
+	for (int i = n - 1; i >= 0; i--) E = E * T + c[i];
+	if (T >= 0.0) E += 0.118597600000E+00 * exp(-0.118343200000E-03 * (T - 0.126968600000E+03) * (T - 0.126968600000E+03));
+	return E;
+} //===============================================================================================
+
+/*
+NIST ITS-90 type K inverse polynomials, mV to C, -200C to 1372C
+*/
+double MAX31856NISTTypeKInverse(double E) {
+	static const double Low[] = { 0.0, 2.5173462E+01, -1.1662878E+00, -1.0833638E+00, -8.9773540E-01, -3.7342377E-01,
+		-8.6632643E-02, -1.0450598E-02, -5.1920577E-04 };
+	static const double Mid[] = { 0.0, 2.508355E+01, 7.860106E-02, -2.503131E-01, 8.315270E-02, -1.228034E-02, 9.804036E-04,
+		-4.413030E-05, 1.057734E-06, -1.052755E-08 };
+	static const double High[] = { -1.318058E+02, 4.830222E+01, -1.646031E+00, 5.464731E-02, -9.650715E-04, 8.802193E-06,
+		-3.110810E-08 };
+	const double * d = High;
+	int n = 7;
+	if (E < 0.0) { d = Low; n = 9; }
+	else if (E < 20.644) { d = Mid; n = 10; }
+	double T = 0.0;
+	for (int i = n - 1; i >= 0; i--) T = T * E + d[i];
+	return T;
+} //===============================================================================================
+
+int main() {
+	bool Pass = true;
+
+	printf("%-16s %9s %9s %9s %9s\n", "Range C", "Max C", "Limit C", "EMF uV", "Inverse C");
+	for (uint8_t r = 0; r < sizeof(MAX31856TypeKLimits) / sizeof(MAX31856TypeKLimits[0]); r++) {
+		const struct MAX31856TypeKLimit_Struct * L = &MAX31856TypeKLimits[r];
+		double WorstC = 0.0, WorstUV = 0.0, WorstInverse = 0.0;
+		for (double T = L->TMin; T <= L->TMax + 1e-9; T += MAX31856_CHECK_STEP_C) {
+			double E = MAX31856NISTTypeK(T);
+			WorstC = fmax(WorstC, fabs(MAX31856TemperatureFromEMF(&MAX31856TypeK, E * 1.0E-3) - T));
+			WorstUV = fmax(WorstUV, fabs(MAX31856EMFFromTemperature(&MAX31856TypeK, T) * 1.0E6 - E * 1.0E3));
+			if (T >= -200.0) WorstInverse = fmax(WorstInverse, fabs(MAX31856TemperatureFromEMF(&MAX31856TypeK, E * 1.0E-3) - MAX31856NISTTypeKInverse(E)));
+		}
+		char Range[32];
+		snprintf(Range, sizeof(Range), "%.0f to %.0f", L->TMin, L->TMax);
+		printf("%-16s %9.4f %9.3f %9.3f", Range, WorstC, L->MaxErrorC, WorstUV);
+		if (L->TMax > -200.0) printf(" %9.4f", WorstInverse);
+		else printf(" %9s", "-");
+		if (WorstC > L->MaxErrorC || WorstUV > MAX31856_CHECK_EMF_UV) {
+			printf("  FAIL");
+			Pass = false;
+		}
+		printf("\n");
+	}
+
+	double WorstCJ = 0.0;
+	for (double CJT = -20.0; CJT <= 80.0; CJT += 0.5) {
+		for (double T = -200.0; T <= 1372.0; T += 0.25) {
+			double Volts = (MAX31856NISTTypeK(T) - MAX31856NISTTypeK(CJT)) * 1.0E-3;
+			WorstCJ = fmax(WorstCJ, fabs(MAX31856Linearize(&MAX31856TypeK, Volts, CJT) - T));
+		}
+	}
+	printf("\nCold junction compensated, CJT -20 to 80C, T -200 to 1372C: %.4fC (limit %.3fC)%s\n", WorstCJ, MAX31856_CHECK_CJ_C,
+		(WorstCJ > MAX31856_CHECK_CJ_C) ? "  FAIL" : "");
+	if (WorstCJ > MAX31856_CHECK_CJ_C) Pass = false;
+
+	bool Outside = isnan(MAX31856TemperatureFromEMF(&MAX31856TypeK, 0.06)) && isnan(MAX31856EMFFromTemperature(&MAX31856TypeK, -271.0))
+		&& isnan(MAX31856EMFFromTemperature(&MAX31856TypeK, 1372.5));
+	printf("Outside of the tables gives NAN: %s\n", Outside ? "yes" : "NO  FAIL");
+	if (!Outside) Pass = false;
+
+	printf("%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================
@@ -0,0 +1,187 @@
+/*
+MAX31856WarmStart()/MAX31856BusWarmStart() against the simulator
+GitHub.com/TerryJMyers
+
+Puts MAX31856_CHECK_DEVICES simulated MAX31856 on one bus and boots them from a MAX31856_Record_Struct the way a sketch
+would, with the device handles begun afresh each time as after a reset of the micro:
+	bad magic		the record is refused and nothing goes on the bus
+	bad version
+	bad CRC			one byte of the image flipped after the record was made
+	cold			devices at their power on defaults, every one rewritten and converting to the record afterwards
+	warm			devices already holding the record, one 17 byte read each, nothing written, no conversion restarted,
+					the sample read on the way already good, and a MAX31856WriteRegisters() afterwards sends nothing
+	one reset			one device power cycled back to its defaults, only that one rewritten
+	one changed		one device with a different AVGSEL, only that one rewritten
+	external CJ		a record with CR0.CJ set, where CJTH/CJTL are configuration and have to match too
+Prints the return code, bus transactions, devices whose registers differ from the record and devices whose conversion was
+restarted for each case.  The record is made from an image with ONESHOT and FAULTCLR set, which MAX31856RecordMake() has to leave out
+or no device could ever match.  Exits with 1 if any case failed.
+
+Build (Linux/macOS):
+	g++ -std=gnu++11 -O2 -I. -o MAX31856WarmStartCheck extras/host/MAX31856WarmStartCheck.cpp
+*/
+#include "MAX31856Host.h"
+#include "../../MAX31856.h"
+#include "MAX31856Sim.h"
+
+#define MAX31856_CHECK_DEVICES		4
+#define MAX31856_CHECK_RUN_MICROS	1000000		//Converting between boots
+
+MAX31856Sim_Struct MAX31856CheckSim[MAX31856_CHECK_DEVICES];
+MAX31856_Device_Struct MAX31856CheckTC[MAX31856_CHECK_DEVICES];
+MAX31856_Bus_Struct MAX31856CheckBus;
+uint64_t MAX31856CheckDoneNanos[MAX31856_CHECK_DEVICES];
+
+/*
+Record of a type K configuration in automatic conversion.  CJ sets CR0.CJ with the cold junction written as CJTH/CJTL
+*/
+void MAX31856CheckRecord(struct MAX31856_Record_Struct * R, bool CJ) {
+	MAX31856_REG_Struct M;
+	memset((void *)&M, 0, sizeof(M));
+	M.REG.CR0.CMODE = true;
+	M.REG.CR0.OCFAULT0 = true;
+	M.REG.CR0.CJ = CJ;
+	M.REG.CR0.ONESHOT = true;
+	M.REG.CR0.FAULTCLR = true;
+	M.REG.CR1.TCTYPE = 3;
+	M.REG.CR1.AVGSEL = 1;
+	M.REG.MASK.WORD = 0x3C;
+	M.REG.CJHF = 70;
+	M.REG.CJLF = -10;
+	M.REG.LTHFT.LTHFT = 1200 * 16;
+	M.REG.LTLFT.LTLFT = -50 * 16;
+	M.REG.CJT.CJT = 25 * 256;
+	MAX31856RecordMake(R, &M);
+} //===============================================================================================
+
+/*
+Micro reset: fresh device handles, the simulators carry on as they were
+*/
+void MAX31856CheckBoot() {
+	MAX31856SimUpdateAll();
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		MAX31856Begin(&MAX31856CheckTC[i], i);
+		MAX31856CheckDoneNanos[i] = MAX31856CheckSim[i].DoneNanos;
+	}
+	MAX31856BusBegin(&MAX31856CheckBus, &MAX31856CheckTC[0], MAX31856_CHECK_DEVICES);
+} //===============================================================================================
+
+/*
+Devices whose configuration registers differ from the record, CJTH/CJTL left out while the internal sensor writes them
+*/
+uint8_t MAX31856CheckDiffer(const struct MAX31856_Record_Struct * R) {
+	uint8_t Differ = 0;
+	uint8_t Compare = (R->Image[0] & 0x08) ? 12 : 10;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		if (memcmp(&MAX31856CheckSim[i].Registers[0], &R->Image[0], Compare) != 0) Differ++;
+	}
+	return Differ;
+} //===============================================================================================
+
+/*
+Devices whose conversion timing moved off the one they had at the boot, i.e. a conversion was started over
+*/
+uint8_t MAX31856CheckRestarted() {
+	uint8_t Restarted = 0;
+	MAX31856SimUpdateAll();
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		uint64_t Period = MAX31856SimConversionNanos(&MAX31856CheckSim[i]);
+		if (!MAX31856CheckSim[i].Converting || (MAX31856CheckSim[i].DoneNanos - MAX31856CheckDoneNanos[i]) % Period != 0) Restarted++;
+	}
+	return Restarted;
+} //===============================================================================================
+
+bool MAX31856CheckRow(const char * Name, int8_t Result, int8_t Expect, uint32_t Transactions, uint8_t Differ, uint8_t Restarted, bool Pass) {
+	Pass = Pass && Result == Expect;
+	printf("%-18s %6d %12lu %6u %9u %5s\n", Name, Result, (unsigned long)Transactions, Differ, Restarted, Pass ? "ok" : "FAIL");
+	return Pass;
+} //===============================================================================================
+
+int main() {
+	bool Pass = true;
+	MAX31856_Record_Struct Record, Bad;
+	MAX31856CheckRecord(&Record, false);
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		MAX31856SimBegin(&MAX31856CheckSim[i], i);
+		MAX31856CheckSim[i].Temperature = 100.0 + 10.0 * i;
+	}
+	MAX31856SimAttach(&MAX31856CheckSim[0], MAX31856_CHECK_DEVICES);
+	printf("%-18s %6s %12s %6s %9s\n", "Case", "Result", "Transactions", "Differ", "Restarted");
+	Pass &= MAX31856CheckRow("record", 0, 0, 0, 0, 0, (Record.Image[0] & 0x42) == 0 && MAX31856RecordValid(&Record));
+
+	//Records that must not be trusted, by either entry point
+	const char * BadNames[3] = { "bad magic", "bad version", "bad CRC" };
+	for (uint8_t b = 0; b < 3; b++) {
+		Bad = Record;
+		if (b == 0) Bad.Magic ^= 0x0100;
+		if (b == 1) Bad.Version++;
+		if (b == 2) Bad.Image[1] ^= 0x10;
+		MAX31856CheckBoot();
+		uint32_t Transactions = MAX31856SPICounters.Transactions;
+		int8_t Result = MAX31856BusWarmStart(&MAX31856CheckBus, &Bad);
+		bool Single = MAX31856WarmStart(&MAX31856CheckTC[0], &Bad) == MAX31856_WARM_BAD_RECORD;
+		Transactions = MAX31856SPICounters.Transactions - Transactions;
+		Pass &= MAX31856CheckRow(BadNames[b], Result, MAX31856_WARM_BAD_RECORD, Transactions, MAX31856CheckDiffer(&Record), 0,
+			Single && Transactions == 0 && !MAX31856RecordValid(&Bad));
+	}
+
+	//Power on: everything rewritten and converting afterwards
+	MAX31856CheckBoot();
+	uint32_t Transactions = MAX31856SPICounters.Transactions;
+	int8_t Result = MAX31856BusWarmStart(&MAX31856CheckBus, &Record);
+	Transactions = MAX31856SPICounters.Transactions - Transactions;
+	uint8_t Converting = 0;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) Converting += MAX31856CheckSim[i].Converting;
+	Pass &= MAX31856CheckRow("cold", Result, MAX31856_CHECK_DEVICES, Transactions, MAX31856CheckDiffer(&Record), 0,
+		MAX31856CheckDiffer(&Record) == 0 && Converting == MAX31856_CHECK_DEVICES);
+
+	//Reset of the micro only: one read each, nothing written or restarted, the sample read on the way is the live one
+	MAX31856HostAdvanceMicros(MAX31856_CHECK_RUN_MICROS);
+	MAX31856CheckBoot();
+	Transactions = MAX31856SPICounters.Transactions;
+	Result = MAX31856BusWarmStart(&MAX31856CheckBus, &Record);
+	uint8_t Restarted = MAX31856CheckRestarted();
+	bool Good = true;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) {
+		MAX31856Calculate(&MAX31856CheckTC[i].M);
+		if (fabs(MAX31856CheckTC[i].M.LTCT - MAX31856CheckSim[i].Temperature) > 0.01) Good = false;
+	}
+	uint32_t Reads = MAX31856SPICounters.Transactions - Transactions;
+	for (uint8_t i = 0; i < MAX31856_CHECK_DEVICES; i++) MAX31856WriteRegisters(&MAX31856CheckTC[i]);
+	Transactions = MAX31856SPICounters.Transactions - Transactions;
+	Pass &= MAX31856CheckRow("warm", Result, MAX31856_WARM_MATCH, Transactions, MAX31856CheckDiffer(&Record), Restarted,
+		Reads == MAX31856_CHECK_DEVICES && Transactions == Reads && Restarted == 0 && Good);
+
+	//One device power cycled, another reprogrammed: only that one is touched each time.  Turning CMODE on starts the first
+	//conversion, a CR1 write leaves the running one alone
+	for (uint8_t c = 0; c < 2; c++) {
+		MAX31856HostAdvanceMicros(MAX31856_CHECK_RUN_MICROS);
+		if (c == 0) MAX31856SimBegin(&MAX31856CheckSim[2], 2);
+		else MAX31856CheckSim[1].Registers[1] ^= 0x10;	//AVGSEL 1 to 0
+		MAX31856CheckBoot();
+		Transactions = MAX31856SPICounters.Transactions;
+		Result = MAX31856BusWarmStart(&MAX31856CheckBus, &Record);
+		Transactions = MAX31856SPICounters.Transactions - Transactions;
+		Restarted = MAX31856CheckRestarted();
+		Pass &= MAX31856CheckRow(c == 0 ? "one reset" : "one changed", Result, 1, Transactions, MAX31856CheckDiffer(&Record),
+			Restarted, MAX31856CheckDiffer(&Record) == 0 && Restarted == 1 - c && Transactions > MAX31856_CHECK_DEVICES);
+	}
+
+	//External cold junction: CJTH/CJTL are part of the configuration, a different value is rewritten, the same one matches
+	MAX31856CheckRecord(&Record, true);
+	MAX31856CheckBoot();
+	Result = MAX31856BusWarmStart(&MAX31856CheckBus, &Record);
+	bool Rewritten = Result == MAX31856_CHECK_DEVICES && MAX31856CheckDiffer(&Record) == 0;
+	MAX31856HostAdvanceMicros(MAX31856_CHECK_RUN_MICROS);
+	MAX31856CheckSim[3].Registers[11] ^= 0x40;
+	MAX31856CheckBoot();
+	Transactions = MAX31856SPICounters.Transactions;
+	Result = MAX31856BusWarmStart(&MAX31856CheckBus, &Record);
+	Transactions = MAX31856SPICounters.Transactions - Transactions;
+	Restarted = MAX31856CheckRestarted();
+	Pass &= MAX31856CheckRow("external CJ", Result, 1, Transactions, MAX31856CheckDiffer(&Record), Restarted,
+		Rewritten && MAX31856CheckDiffer(&Record) == 0 && Restarted == 0);
+
+	printf("\n%s\n", Pass ? "PASS" : "FAIL");
+	return Pass ? 0 : 1;
+} //===============================================================================================